@@ -0,0 +1,10 @@
+find_path(ZMQ_INCLUDE_DIR zmq.h)
+message(STATUS "ZMQ PATH ${ZMQ_INCLUDE_DIR}")
+
+find_library(ZMQ_LIBRARY zmq)
+message(STATUS "ZMQ LIBRARY ${ZMQ_LIBRARY}")
+
+mark_as_advanced(ZMQ_LIBRARY ZMQ_INCLUDE_DIR)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(ZMQ DEFAULT_MSG ZMQ_LIBRARY ZMQ_INCLUDE_DIR)
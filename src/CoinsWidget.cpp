@@ -4,10 +4,12 @@
 #include "CoinsWidget.h"
 #include "ui_CoinsWidget.h"
 
+#include <QInputDialog>
 #include <QMessageBox>
 
 #include "dialog/OutputInfoDialog.h"
 #include "dialog/OutputSweepDialog.h"
+#include "libwalletqt/WalletManager.h"
 #include "utils/Icons.h"
 #include "utils/Utils.h"
 
@@ -29,6 +31,16 @@ CoinsWidget::CoinsWidget(Wallet *wallet, QWidget *parent)
     m_showSpentAction = m_headerMenu->addAction("Show spent outputs", this, &CoinsWidget::setShowSpent);
     m_showSpentAction->setCheckable(true);
     connect(ui->coins->header(), &QHeaderView::customContextMenuRequested, this, &CoinsWidget::showHeaderMenu);
+
+    // coin control
+    m_headerMenu->addSeparator();
+    QMenu *autoSelectMenu = m_headerMenu->addMenu("Select coins for amount");
+    for (int i = 0; i < CoinSelector::COUNT; i++) {
+        auto strategy = static_cast<CoinSelector::Strategy>(i);
+        autoSelectMenu->addAction(CoinSelector::strategyName(strategy), this, [this, strategy]{
+            this->autoSelectCoins(strategy);
+        });
+    }
     ui->btn_options->setMenu(m_headerMenu);
 
     // copy menu
@@ -77,7 +89,9 @@ CoinsWidget::CoinsWidget(Wallet *wallet, QWidget *parent)
 
     connect(ui->search, &QLineEdit::textChanged, this, &CoinsWidget::setSearchFilter);
 
-    connect(m_wallet, &Wallet::selectedInputsChanged, this, &CoinsWidget::selectCoins);
+    connect(m_wallet->coins()->selection(), &CoinSelection::changed, this, [this]{
+        ui->coins->clearSelection();
+    });
 }
 
 void CoinsWidget::setModel(CoinsModel * model, Coins * coins) {
@@ -102,6 +116,17 @@ void CoinsWidget::setModel(CoinsModel * model, Coins * coins) {
     ui->coins->setSortingEnabled(true);
 }
 
+void CoinsWidget::showEvent(QShowEvent *event) {
+    // The model is built the first time the tab is shown
+    if (!m_model) {
+        this->setModel(m_wallet->coinsModel(), m_wallet->coins());
+        this->setShowSpent(m_showSpentAction->isChecked());
+        this->setSearchFilter(ui->search->text());
+    }
+
+    QWidget::showEvent(event);
+}
+
 void CoinsWidget::setSearchbarVisible(bool visible) {
     ui->frame_search->setVisible(visible);
 }
@@ -111,6 +136,10 @@ void CoinsWidget::focusSearchbar() {
     ui->search->setFocus();
 }
 
+void CoinsWidget::setSearchText(const QString &text) {
+    ui->search->setText(text);
+}
+
 void CoinsWidget::showContextMenu(const QPoint &point) {
     QModelIndexList list = ui->coins->selectionModel()->selectedRows();
 
@@ -130,7 +159,7 @@ void CoinsWidget::showContextMenu(const QPoint &point) {
 
         bool isSpent = c.spent;
         bool isFrozen = c.frozen;
-        bool isUnlocked = c.unlocked;
+        bool isUnlocked = c.unlocked(m_wallet->coins()->height());
 
         menu->addAction(m_spendAction);
         menu->addMenu(m_copyMenu);
@@ -174,7 +203,7 @@ QStringList CoinsWidget::selectedPubkeys() {
 
     QStringList pubkeys;
     for (QModelIndex index: list) {
-        pubkeys << m_model->entryFromIndex(m_proxyModel->mapToSource(index)).pubKey;
+        pubkeys << m_model->entryFromIndex(m_proxyModel->mapToSource(index)).pubKey();
     }
     return pubkeys;
 }
@@ -192,7 +221,8 @@ void CoinsWidget::thawAllSelected() {
 void CoinsWidget::spendSelected() {
     QModelIndexList selectedRows = ui->coins->selectionModel()->selectedRows();
 
-    QStringList keyimages;
+    QList<CoinsInfo> coins;
+    coins.reserve(selectedRows.size());
     for (const auto index : selectedRows) {
         if (!index.isValid()) {
             return;
@@ -202,12 +232,49 @@ void CoinsWidget::spendSelected() {
         bool spendable = this->isCoinSpendable(coin);
         if (!spendable) return;
 
-        QString keyImage = coin.keyImage;
-        keyimages << keyImage;
+        coins << coin;
     }
 
-    m_wallet->setSelectedInputs(keyimages);
-    this->selectCoins(keyimages);
+    m_wallet->coins()->selection()->set(coins);
+}
+
+void CoinsWidget::autoSelectCoins(CoinSelector::Strategy strategy) {
+    CoinSelector::Params params;
+    params.strategy = strategy;
+    params.walletHeight = m_wallet->coins()->height();
+
+    // Consolidation works without a target, it picks as many small outputs as fit in one transaction
+    if (strategy != CoinSelector::ConsolidateDust) {
+        bool ok;
+        QString amount = QInputDialog::getText(this, "Select coins", "Amount to cover (XMR):", QLineEdit::Normal, "", &ok);
+        if (!ok) {
+            return;
+        }
+        params.target = WalletManager::amountFromString(amount);
+        if (params.target == 0) {
+            Utils::showError(this, "Unable to select coins", "Invalid amount");
+            return;
+        }
+    }
+
+    // Without a fee estimate every spendable output is considered worth spending. Fetching one here
+    // would block the window on a daemon RPC.
+    params.feePerInput = m_wallet->cachedBaseFee() * CoinSelector::inputWeight;
+
+    const QList<CoinsInfo> &rows = m_wallet->coins()->getRows();
+    QList<qsizetype> picked = CoinSelector::select(rows, params);
+    if (picked.isEmpty()) {
+        Utils::showError(this, "Unable to select coins", "Not enough spendable outputs",
+                         {"Frozen and locked outputs are not considered.", "Outputs that cost more to spend than they are worth are not considered."});
+        return;
+    }
+
+    QList<CoinsInfo> coins;
+    coins.reserve(picked.size());
+    for (qsizetype index : picked) {
+        coins << rows[index];
+    }
+    m_wallet->coins()->selection()->set(coins);
 }
 
 void CoinsWidget::viewOutput() {
@@ -217,7 +284,7 @@ void CoinsWidget::viewOutput() {
     }
     const CoinsInfo& c = m_model->entryFromIndex(index);
 
-    auto * dialog = new OutputInfoDialog(c, this);
+    auto * dialog = new OutputInfoDialog(c, m_wallet->coins()->address(c), this);
     dialog->show();
 }
 
@@ -248,7 +315,7 @@ void CoinsWidget::onSweepOutputs() {
         bool spendable = this->isCoinSpendable(coin);
         if (!spendable) return;
 
-        QString keyImage = coin.keyImage;
+        QString keyImage = coin.keyImage();
         keyImages.push_back(keyImage);
         totalAmount += coin.amount;
     }
@@ -293,16 +360,16 @@ void CoinsWidget::copy(copyField field) {
     QString data;
     switch (field) {
         case PubKey:
-            data = c.pubKey;
+            data = c.pubKey();
             break;
         case KeyImage:
-            data = c.keyImage;
+            data = c.keyImage();
             break;
         case TxID:
-            data = c.hash;
+            data = c.hash();
             break;
         case Address:
-            data = c.address;
+            data = m_wallet->coins()->address(c);
             break;
         case Label: {
             if (!c.description.isEmpty())
@@ -324,17 +391,10 @@ void CoinsWidget::copy(copyField field) {
 
 void CoinsWidget::freezeCoins(QStringList &pubkeys) {
     m_wallet->coins()->freeze(pubkeys);
-    m_wallet->updateBalance();
 }
 
 void CoinsWidget::thawCoins(QStringList &pubkeys) {
     m_wallet->coins()->thaw(pubkeys);
-    m_wallet->updateBalance();
-}
-
-void CoinsWidget::selectCoins(const QStringList &keyimages) {
-    m_model->setSelected(keyimages);
-    ui->coins->clearSelection();
 }
 
 void CoinsWidget::editLabel() {
@@ -359,7 +419,7 @@ bool CoinsWidget::isCoinSpendable(const CoinsInfo &coin) {
         return false;
     }
 
-    if (!coin.unlocked) {
+    if (!coin.unlocked(m_wallet->coins()->height())) {
         Utils::showError(this, "Unable to spend outputs", "Selected output is locked", {"Wait until the output has reached the required number of confirmation before spending."});
         return false;
     }
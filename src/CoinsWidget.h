@@ -10,6 +10,7 @@
 
 #include "model/CoinsModel.h"
 #include "model/CoinsProxyModel.h"
+#include "libwalletqt/CoinSelector.h"
 #include "libwalletqt/Coins.h"
 #include "libwalletqt/Wallet.h"
 
@@ -31,9 +32,13 @@ public:
 signals:
     void spendSelectedChanged(const QStringList &pubkeys);
 
+protected:
+    void showEvent(QShowEvent *event) override;
+
 public slots:
     void setSearchbarVisible(bool visible);
     void focusSearchbar();
+    void setSearchText(const QString &text);
 
 private slots:
     void showHeaderMenu(const QPoint& position);
@@ -49,7 +54,7 @@ private slots:
 private:
     void freezeCoins(QStringList &pubkeys);
     void thawCoins(QStringList &pubkeys);
-    void selectCoins(const QStringList &pubkeys);
+    void autoSelectCoins(CoinSelector::Strategy strategy);
 
     enum copyField {
         PubKey = 0,
@@ -77,9 +82,9 @@ private:
     QAction *m_sweepOutputAction;
     QAction *m_sweepOutputsAction;
     QAction *m_editLabelAction;
-    Coins *m_coins;
-    CoinsModel * m_model;
-    CoinsProxyModel * m_proxyModel;
+    Coins *m_coins = nullptr;
+    CoinsModel * m_model = nullptr;
+    CoinsProxyModel * m_proxyModel = nullptr;
 
     void showContextMenu(const QPoint & point);
     void copy(copyField field);
@@ -90,6 +90,10 @@ void ContactsWidget::focusSearchbar() {
     ui->search->setFocus();
 }
 
+void ContactsWidget::setSearchText(const QString &text) {
+    ui->search->setText(text);
+}
+
 void ContactsWidget::copyAddress() {
     QModelIndex index = ui->contacts->currentIndex();
     Utils::copyColumn(&index, AddressBookModel::Address);
@@ -35,6 +35,7 @@ public slots:
     void deleteContact();
     void setShowFullAddresses(bool show);
     void setSearchFilter(const QString &filter);
+    void setSearchText(const QString &text);
 
 signals:
     void fill(QString &address, QString &description);
@@ -4,11 +4,13 @@
 #include "HistoryWidget.h"
 #include "ui_HistoryWidget.h"
 
+#include <QLabel>
 #include <QMessageBox>
 
 #include "dialog/TxInfoDialog.h"
 #include "dialog/TxProofDialog.h"
 #include "model/TransactionHistoryProxyModel.h"
+#include "libwalletqt/TransactionHistory.h"
 #include "libwalletqt/Wallet.h"
 #include "libwalletqt/WalletManager.h"
 #include "utils/config.h"
@@ -21,7 +23,8 @@ HistoryWidget::HistoryWidget(Wallet *wallet, QWidget *parent)
         , m_wallet(wallet)
         , m_contextMenu(new QMenu(this))
         , m_copyMenu(new QMenu("Copy", this))
-        , m_model(wallet->historyModel())
+        , m_model(nullptr)
+        , m_placeholder(new QLabel("Loading transactions…", this))
 {
     ui->setupUi(this);
     m_contextMenu->addMenu(m_copyMenu);
@@ -54,6 +57,31 @@ HistoryWidget::HistoryWidget(Wallet *wallet, QWidget *parent)
     connect(m_wallet, &Wallet::walletRefreshed, this, &HistoryWidget::onWalletRefreshed);
 
     ui->syncNotice->setVisible(conf()->get(Config::showHistorySyncNotice).toBool());
+
+    // Shown in place of the view until the first build is done
+    m_placeholder->setAlignment(Qt::AlignCenter);
+    m_placeholder->setEnabled(false);
+    ui->verticalLayout->insertWidget(ui->verticalLayout->indexOf(ui->history), m_placeholder);
+    m_placeholder->hide();
+    connect(m_wallet->history(), &TransactionHistory::refreshFinished, this, [this]{
+        m_placeholder->hide();
+        ui->history->show();
+    });
+
+    ui->btn_options->setMenu(ui->history->getMenu());
+}
+
+void HistoryWidget::showEvent(QShowEvent *event) {
+    // History isn't built until its tab is shown for the first time
+    if (!m_model) {
+        this->setHistoryModel();
+    }
+
+    QWidget::showEvent(event);
+}
+
+void HistoryWidget::setHistoryModel() {
+    m_model = m_wallet->historyModel();
     ui->history->setHistoryModel(m_model);
 
     // Load view state
@@ -62,7 +90,12 @@ HistoryWidget::HistoryWidget(Wallet *wallet, QWidget *parent)
         ui->history->setViewState(historyViewState);
     }
 
-    ui->btn_options->setMenu(ui->history->getMenu());
+    ui->history->setColumnHidden(TransactionHistoryModel::FiatAmount, !m_websocketEnabled);
+    this->setSearchFilter(ui->search->text());
+
+    bool loaded = m_wallet->history()->loaded();
+    m_placeholder->setVisible(!loaded);
+    ui->history->setVisible(loaded);
 }
 
 void HistoryWidget::setSearchbarVisible(bool visible) {
@@ -75,6 +108,10 @@ void HistoryWidget::focusSearchbar() {
 }
 
 void HistoryWidget::setWebsocketEnabled(bool enabled) {
+    m_websocketEnabled = enabled;
+    if (!m_model) {
+        return;
+    }
     ui->history->setColumnHidden(TransactionHistoryModel::FiatAmount, !enabled);
 }
 
@@ -115,7 +152,7 @@ void HistoryWidget::onResendTransaction() {
         return;
     }
     const TransactionRow& tx = ui->history->sourceModel()->entryFromIndex(index);
-    emit resendTransaction(tx.hash);
+    emit resendTransaction(tx.hash());
 }
 
 void HistoryWidget::onRemoveFromHistory() {
@@ -127,12 +164,17 @@ void HistoryWidget::onRemoveFromHistory() {
 
     auto result = QMessageBox::question(this, "Remove transaction from history", "Are you sure you want to remove this transaction from the history?");
     if (result == QMessageBox::Yes) {
-        m_wallet->removeFailedTx(tx.hash);
+        m_wallet->removeFailedTx(tx.hash());
     }
 }
 
 void HistoryWidget::resetModel()
 {
+    // The view state was never loaded, don't overwrite it with the defaults
+    if (!m_model) {
+        return;
+    }
+
     // Save view state
     conf()->set(Config::GUI_HistoryViewState, ui->history->viewState().toBase64());
     conf()->sync();
@@ -162,7 +204,7 @@ void HistoryWidget::onViewOnBlockExplorer() {
     }
     const TransactionRow& tx = ui->history->sourceModel()->entryFromIndex(index);
 
-    emit viewOnBlockExplorer(tx.hash);
+    emit viewOnBlockExplorer(tx.hash());
 }
 
 void HistoryWidget::setSearchText(const QString &text) {
@@ -170,6 +212,9 @@ void HistoryWidget::setSearchText(const QString &text) {
 }
 
 void HistoryWidget::setSearchFilter(const QString &filter) {
+    if (!m_model) {
+        return;
+    }
     m_model->setSearchFilter(filter);
     ui->history->setSearchMode(!filter.isEmpty());
 }
@@ -196,7 +241,7 @@ void HistoryWidget::copy(copyField field) {
     QString data = [field, tx]{
         switch(field) {
             case copyField::TxID:
-                return tx.hash;
+                return tx.hash();
             case copyField::Description:
                 return tx.description;
             case copyField::Date:
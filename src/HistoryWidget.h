@@ -7,6 +7,7 @@
 #include <QWidget>
 #include <QMenu>
 
+class QLabel;
 class TransactionHistoryProxyModel;
 class Wallet;
 
@@ -35,6 +36,9 @@ signals:
     void viewOnBlockExplorer(QString txid);
     void resendTransaction(QString txid);
 
+protected:
+    void showEvent(QShowEvent *event) override;
+
 private slots:
     void showTxDetails();
     void onViewOnBlockExplorer();
@@ -51,6 +55,7 @@ private:
         Amount
     };
 
+    void setHistoryModel();
     void copy(copyField field);
     void showContextMenu(const QPoint &point);
     void showSyncNoticeMsg();
@@ -60,6 +65,8 @@ private:
     QMenu *m_contextMenu;
     QMenu *m_copyMenu;
     TransactionHistoryProxyModel *m_model;
+    QLabel *m_placeholder;
+    bool m_websocketEnabled = false;
 };
 
 #endif //FEATHER_HISTORYWIDGET_H
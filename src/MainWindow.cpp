@@ -8,6 +8,7 @@
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QCheckBox>
+#include <QMenu>
 
 #include "constants.h"
 #include "dialog/AddressCheckerIndexDialog.h"
@@ -28,12 +29,15 @@
 #include "libwalletqt/rows/CoinsInfo.h"
 #include "libwalletqt/rows/Output.h"
 #include "libwalletqt/TransactionHistory.h"
+#include "libwalletqt/WalletSearch.h"
+#include "libwalletqt/WalletSyncCoordinator.h"
 #include "model/AddressBookModel.h"
 #include "plugins/PluginRegistry.h"
 #include "utils/AppData.h"
 #include "utils/AsyncTask.h"
 #include "utils/ColorScheme.h"
 #include "utils/Icons.h"
+#include "utils/StartupProfiler.h"
 #include "utils/TorManager.h"
 #include "utils/WebsocketNotifier.h"
 
@@ -62,7 +66,6 @@ MainWindow::MainWindow(WindowManager *windowManager, Wallet *wallet, QWidget *pa
     setAttribute(Qt::WA_DeleteOnClose);
 
     m_splashDialog = new SplashDialog(this);
-    m_accountSwitcherDialog = new AccountSwitcherDialog(m_wallet, this);
 
 #ifdef CHECK_UPDATES
     m_updater = QSharedPointer<Updater>(new Updater(this));
@@ -70,13 +73,16 @@ MainWindow::MainWindow(WindowManager *windowManager, Wallet *wallet, QWidget *pa
 
     this->restoreGeo();
 
-    this->initStatusBar();
-    this->initPlugins();
-    this->initWidgets();
-    this->initMenu();
-    this->initOffline();
-    this->initWalletContext();
-    emit uiSetup();
+    {
+        StartupProfiler::Span span("main_window_setup");
+        this->initStatusBar();
+        this->initPlugins();
+        this->initWidgets();
+        this->initMenu();
+        this->initOffline();
+        this->initWalletContext();
+        emit uiSetup();
+    }
 
     this->onOfflineMode(conf()->get(Config::offlineMode).toBool());
     conf()->set(Config::restartRequired, false);
@@ -92,7 +98,10 @@ MainWindow::MainWindow(WindowManager *windowManager, Wallet *wallet, QWidget *pa
     this->onWebsocketStatusChanged(!conf()->get(Config::disableWebsocket).toBool());
 
     connect(m_windowManager, &WindowManager::proxySettingsChanged, this, &MainWindow::onProxySettingsChangedConnect);
-    connect(m_windowManager, &WindowManager::updateBalance, m_wallet, &Wallet::updateBalance);
+    // Display settings changed, balances did not
+    connect(m_windowManager, &WindowManager::updateBalance, m_wallet, [this]{
+        m_wallet->updateBalance(true);
+    });
     connect(m_windowManager, &WindowManager::offlineMode, this, &MainWindow::onOfflineMode);
     connect(m_windowManager, &WindowManager::manualFeeSelectionEnabled, this, &MainWindow::onManualFeeSelectionEnabled);
     connect(m_windowManager, &WindowManager::subtractFeeFromAmountEnabled, this, &MainWindow::onSubtractFeeFromAmountEnabled);
@@ -191,6 +200,7 @@ void MainWindow::initStatusBar() {
 }
 
 void MainWindow::initPlugins() {
+    StartupProfiler::Span span("plugins_init");
     const QStringList enabledPlugins = conf()->get(Config::enabledPlugins).toStringList();
 
     for (const auto& plugin_creator : PluginRegistry::getPluginCreators()) {
@@ -247,6 +257,15 @@ void MainWindow::initWidgets() {
         ui->tabWidget->setCurrentIndex(this->findTab("Send"));
     });
 
+    // [Quick find]
+    m_quickFind = new QLineEdit(this);
+    m_quickFind->setPlaceholderText("Find in wallet");
+    m_quickFind->setToolTip("Search transactions, coins, addresses and contacts by txid, key, address or label");
+    m_quickFind->setClearButtonEnabled(true);
+    m_quickFind->setMinimumWidth(250);
+    ui->tabWidget->setCornerWidget(m_quickFind, Qt::TopRightCorner);
+    connect(m_quickFind, &QLineEdit::returnPressed, this, &MainWindow::quickFind);
+
     // [Notes]
     ui->notes->setPlainText(m_wallet->getCacheAttribute("wallet.notes"));
     connect(ui->notes, &QPlainTextEdit::textChanged, [this] {
@@ -274,7 +293,7 @@ void MainWindow::initWidgets() {
 
     ui->frame_coinControl->setVisible(false);
     connect(ui->btn_resetCoinControl, &QPushButton::clicked, [this]{
-       m_wallet->setSelectedInputs({});
+       m_wallet->coins()->selection()->clear();
     });
 
     m_walletUnlockWidget = new WalletUnlockWidget(this, m_wallet);
@@ -312,7 +331,7 @@ void MainWindow::initMenu() {
 
     // [Wallet] -> [Advanced]
     connect(ui->actionStore_wallet,          &QAction::triggered, this, &MainWindow::tryStoreWallet);
-    connect(ui->actionUpdate_balance,        &QAction::triggered, [this]{m_wallet->updateBalance();});
+    connect(ui->actionUpdate_balance,        &QAction::triggered, [this]{m_wallet->updateBalance(true);});
     connect(ui->actionRefresh_tabs,          &QAction::triggered, [this]{m_wallet->refreshModels();});
     connect(ui->actionRescan_spent,          &QAction::triggered, this, &MainWindow::rescanSpent);
     connect(ui->actionWallet_cache_debug,    &QAction::triggered, this, &MainWindow::showWalletCacheDebugDialog);
@@ -480,8 +499,8 @@ void MainWindow::initWalletContext() {
     connect(m_wallet, &Wallet::transactionCommitted,     this, &MainWindow::onTransactionCommitted);
     connect(m_wallet, &Wallet::initiateTransaction,      this, &MainWindow::onInitiateTransaction);
     connect(m_wallet, &Wallet::keysCorrupted,            this, &MainWindow::onKeysCorrupted);
-    connect(m_wallet, &Wallet::selectedInputsChanged,    this, &MainWindow::onSelectedInputsChanged);
     connect(m_wallet, &Wallet::txPoolBacklog,            this, &MainWindow::onTxPoolBacklog);
+    connect(m_wallet->coins()->selection(), &CoinSelection::changed, this, &MainWindow::onSelectedInputsChanged);
 
     // Wallet
     connect(m_wallet, &Wallet::connectionStatusChanged, [this](int status){
@@ -511,6 +530,8 @@ void MainWindow::initWalletContext() {
     connect(m_wallet, &Wallet::deviceError,         this, &MainWindow::onDeviceError);
     
     connect(m_wallet, &Wallet::multiBroadcast,      this, &MainWindow::onMultiBroadcast);
+    connect(m_wallet, &Wallet::stored,              this, &MainWindow::onWalletStored);
+    connect(m_wallet, &Wallet::autosaveFailed,      this, &MainWindow::onAutosaveFailed);
 }
 
 void MainWindow::menuToggleTabVisible(const QString &key){
@@ -554,7 +575,7 @@ void MainWindow::onWalletOpened() {
 
     m_wallet->setRingDatabase(Utils::ringDatabasePath());
 
-    m_wallet->updateBalance();
+    m_wallet->updateBalance(true);
     if (m_wallet->isHwBacked()) {
         m_statusBtnHwDevice->show();
     }
@@ -570,22 +591,14 @@ void MainWindow::onWalletOpened() {
         }
     }
 
-    // history page
-    m_wallet->history()->refresh();
-
-    // coins page
+    // History is built when its tab is first shown, coins are needed for the balance right away.
+    // The coins model is attached when its tab is first shown.
     m_wallet->coins()->refresh();
-    m_coinsWidget->setModel(m_wallet->coinsModel(), m_wallet->coins());
-    m_wallet->coinsModel()->setCurrentSubaddressAccount(m_wallet->currentSubaddressAccount());
 
     // Coin labeling uses set_tx_note, so we need to refresh history too
     connect(m_wallet->coins(), &Coins::descriptionChanged, [this] {
         m_wallet->history()->refresh();
     });
-    // Vice versa
-    connect(m_wallet->transactionHistoryModel(), &TransactionHistoryModel::transactionDescriptionChanged, [this] {
-        m_wallet->coins()->refresh();
-    });
 
     this->updatePasswordIcon();
     this->updateTitle();
@@ -596,6 +609,20 @@ void MainWindow::onWalletOpened() {
     if (conf()->get(Config::writeRecentlyOpenedWallets).toBool()) {
         this->addToRecentlyOpened(m_wallet->cachePath());
     }
+
+    startupProfiler()->mark(StartupProfiler::WalletOpened);
+    if (startupProfiler()->enabled()) {
+        // The first coins build may end in any of these, mark() ignores the rest
+        auto modelsReady = []{
+            startupProfiler()->mark(StartupProfiler::ModelsReady);
+        };
+        connect(m_wallet->coins(), &Coins::refreshFinished, this, modelsReady, Qt::SingleShotConnection);
+        connect(m_wallet->coins(), &Coins::rowsChanged, this, modelsReady, Qt::SingleShotConnection);
+        connect(m_wallet->coins(), &Coins::balancesChanged, this, modelsReady, Qt::SingleShotConnection);
+        connect(m_wallet, &Wallet::syncStatus, this, []{
+            startupProfiler()->mark(StartupProfiler::FirstSyncTick);
+        }, Qt::SingleShotConnection);
+    }
 }
 
 void MainWindow::updateBalance() {
@@ -651,12 +678,28 @@ void MainWindow::setStatusText(const QString &text, bool override, int timeout)
 }
 
 void MainWindow::tryStoreWallet() {
-    if (m_wallet->connectionStatus() == Wallet::ConnectionStatus::ConnectionStatus_Synchronizing) {
-        Utils::showError(this, "Unable to save wallet", "Can't save wallet during synchronization", {"Wait until synchronization is finished and try again"}, "synchronization");
+    // Saved in the background, see onWalletStored()
+    m_storeRequested = true;
+    this->setStatusText("Saving wallet", true, 3000);
+    m_wallet->store();
+}
+
+void MainWindow::onWalletStored(bool success, const QString &error) {
+    // Background stores are only reported if the user asked for one
+    if (!std::exchange(m_storeRequested, false)) {
         return;
     }
 
-    m_wallet->store();
+    if (!success) {
+        Utils::showError(this, "Unable to save wallet", error);
+        return;
+    }
+    this->setStatusText("Wallet saved", true, 3000);
+}
+
+void MainWindow::onAutosaveFailed(const QString &error) {
+    Utils::showError(this, "Unable to save wallet", error, {"Feather keeps trying to save the wallet in the background.",
+                                                             "Make sure the wallet file is writable and the disk isn't full."});
 }
 
 void MainWindow::onWebsocketStatusChanged(bool enabled) {
@@ -1060,19 +1103,31 @@ void MainWindow::onTransactionCommitted(bool success, PendingTransaction *tx, co
     if (msgBox.clickedButton() == showDetailsButton) {
         this->showHistoryTab();
 
-        const auto& rows = m_wallet->history()->getRows();
-        auto itr = std::find_if(rows.begin(), rows.end(),
-                [&](const TransactionRow& ti) {
-            return ti.hash == txid.first();
-        });
-        if (itr == rows.end()) {
-            return;
-        }
+        QString hash = txid.first();
+        auto showDetails = [this, hash] {
+            const auto& rows = m_wallet->history()->getRows();
+            auto itr = std::find_if(rows.begin(), rows.end(),
+                    [&](const TransactionRow& ti) {
+                return ti.hash() == hash;
+            });
+            if (itr == rows.end()) {
+                Utils::showInfo(this, "Unable to show transaction details", "The transaction is not in the history yet",
+                                {"Open it from the History tab in a moment"});
+                return;
+            }
 
-        auto *dialog = new TxInfoDialog(m_wallet, *itr, this);
-        connect(dialog, &TxInfoDialog::resendTranscation, this, &MainWindow::onResendTransaction);
-        dialog->show();
-        dialog->setAttribute(Qt::WA_DeleteOnClose);
+            auto *dialog = new TxInfoDialog(m_wallet, *itr, this);
+            connect(dialog, &TxInfoDialog::resendTranscation, this, &MainWindow::onResendTransaction);
+            dialog->show();
+            dialog->setAttribute(Qt::WA_DeleteOnClose);
+        };
+
+        // The history is built when the tab is first opened, showHistoryTab() only started it
+        if (m_wallet->history()->loaded()) {
+            showDetails();
+        } else {
+            connect(m_wallet->history(), &TransactionHistory::refreshFinished, this, showDetails, Qt::SingleShotConnection);
+        }
     }
 
     m_sendWidget->clearFields();
@@ -1267,6 +1322,11 @@ void MainWindow::closeEvent(QCloseEvent *event) {
 
 void MainWindow::changeEvent(QEvent* event)
 {
+    if (event->type() == QEvent::ActivationChange && this->isActiveWindow()) {
+        // Scans of the wallet the user looks at go first
+        syncCoordinator()->setForeground(m_wallet);
+    }
+
     if ((event->type() == QEvent::WindowStateChange) && this->isMinimized()) {
         if (conf()->get(Config::lockOnMinimize).toBool()) {
             this->lockWallet();
@@ -1355,6 +1415,10 @@ void MainWindow::showTxPoolViewerDialog() {
 }
 
 void MainWindow::showAccountSwitcherDialog() {
+    if (!m_accountSwitcherDialog) {
+        m_accountSwitcherDialog = new AccountSwitcherDialog(m_wallet, this);
+    }
+
     m_accountSwitcherDialog->show();
     m_accountSwitcherDialog->update();
 }
@@ -1662,14 +1726,15 @@ void MainWindow::onKeysCorrupted() {
     }
 }
 
-void MainWindow::onSelectedInputsChanged(const QStringList &selectedInputs) {
-    int numInputs = selectedInputs.size();
+void MainWindow::onSelectedInputsChanged() {
+    CoinSelection *selection = m_wallet->coins()->selection();
+    qsizetype numInputs = selection->count();
 
     ui->frame_coinControl->setStyleSheet(ColorScheme::GREEN.asStylesheet(true));
     ui->frame_coinControl->setVisible(numInputs > 0);
 
     if (numInputs > 0) {
-        quint64 totalAmount = m_wallet->coins()->sumAmounts(selectedInputs);
+        quint64 totalAmount = selection->amount();
 
         QString text = QString("Coin control active: %1 selected outputs, %2 XMR").arg(QString::number(numInputs), WalletManager::displayAmount(totalAmount));
         ui->label_coinControl->setText(text);
@@ -1915,6 +1980,52 @@ void MainWindow::toggleSearchbar(bool visible) {
         m_coinsWidget->focusSearchbar();
 }
 
+void MainWindow::quickFind() {
+    static const QStringList tabs = {"History", "Coins", "Receive", "Contacts"};
+
+    QList<WalletSearch::Result> results = m_wallet->search()->find(m_quickFind->text());
+
+    QMenu menu(this);
+    for (const auto &result : results) {
+        // Results on tabs hidden by the user can't be shown
+        const QString &tab = tabs[result.kind];
+        int tabIndex = this->findTab(tab);
+        if (tabIndex < 0 || !ui->tabWidget->isTabVisible(tabIndex)) {
+            continue;
+        }
+
+        QAction *action = menu.addAction(QString("%1: %2").arg(tab, result.text));
+        connect(action, &QAction::triggered, this, [this, result, tab]{
+            // Narrow the tab down to the result with its own search box
+            ui->actionShow_Searchbar->setChecked(true);
+            switch (result.kind) {
+                case WalletSearch::Result::Transaction:
+                    m_historyWidget->setSearchText(result.key);
+                    break;
+                case WalletSearch::Result::Coin:
+                    m_coinsWidget->setSearchText(result.key);
+                    break;
+                case WalletSearch::Result::Subaddress:
+                    m_receiveWidget->setSearchText(result.key);
+                    break;
+                case WalletSearch::Result::Contact:
+                    m_contactsWidget->setSearchText(result.key);
+                    break;
+            }
+            ui->tabWidget->setCurrentIndex(this->findTab(tab));
+        });
+    }
+    // The first query starts building the history, its transactions are found once it is done
+    if (!m_wallet->history()->loaded()) {
+        menu.addAction("Transactions are still loading, try again in a moment")->setEnabled(false);
+    }
+    else if (menu.isEmpty()) {
+        menu.addAction("No results")->setEnabled(false);
+    }
+
+    menu.exec(m_quickFind->mapToGlobal(QPoint(0, m_quickFind->height())));
+}
+
 int MainWindow::findTab(const QString &title) {
     for (int i = 0; i < ui->tabWidget->count(); i++) {
         if (ui->tabWidget->tabText(i) == title) {
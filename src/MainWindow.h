@@ -127,7 +127,7 @@ private slots:
     void showUpdateDialog();
     void onInitiateTransaction();
     void onKeysCorrupted();
-    void onSelectedInputsChanged(const QStringList &selectedInputs);
+    void onSelectedInputsChanged();
     void onTxPoolBacklog(const QVector<quint64> &backlog, quint64 originalFeeLevel, quint64 automaticFeeLevel);
 
     // libwalletqt
@@ -164,7 +164,10 @@ private slots:
     void onWalletPassphraseNeeded(bool on_device);
     void menuHwDeviceClicked();
     void toggleSearchbar(bool enabled);
+    void quickFind();
     void tryStoreWallet();
+    void onWalletStored(bool success, const QString &error);
+    void onAutosaveFailed(const QString &error);
     void onWebsocketStatusChanged(bool enabled);
     void showUpdateNotification();
     void onProxySettingsChangedConnect();
@@ -229,6 +232,7 @@ private:
     SendWidget *m_sendWidget = nullptr;
     ReceiveWidget *m_receiveWidget = nullptr;
     CoinsWidget *m_coinsWidget = nullptr;
+    QLineEdit *m_quickFind = nullptr;
 
     QPointer<QAction> m_clearRecentlyOpenAction;
 
@@ -258,6 +262,7 @@ private:
     bool m_constructingTransaction = false;
     bool m_statusOverrideActive = false;
     bool m_showDeviceError = false;
+    bool m_storeRequested = false;
     QTimer m_txTimer;
 
     bool cleanedUp = false;
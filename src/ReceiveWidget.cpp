@@ -104,6 +104,10 @@ void ReceiveWidget::focusSearchbar() {
     ui->search->setFocus();
 }
 
+void ReceiveWidget::setSearchText(const QString &text) {
+    ui->search->setText(text);
+}
+
 QString ReceiveWidget::getAddress(quint32 minorIndex) {
     bool ok;
     QString reason;
@@ -36,6 +36,7 @@ public slots:
     void editLabel();
     void showContextMenu(const QPoint& point);
     void setSearchFilter(const QString &filter);
+    void setSearchText(const QString &text);
     void onShowTransactions();
     void createPaymentRequest();
 
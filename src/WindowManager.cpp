@@ -21,6 +21,7 @@
 #include "utils/NetworkManager.h"
 #include "utils/os/tails.h"
 #include "utils/os/whonix.h"
+#include "utils/StartupProfiler.h"
 #include "utils/TorManager.h"
 #include "utils/WebsocketNotifier.h"
 #include "utils/AppData.h"
@@ -132,6 +133,11 @@ void WindowManager::restartApplication(const QString &binaryFilename) {
 }
 
 void WindowManager::startupWarning() {
+    // Nobody is there to dismiss it during a benchmark
+    if (!startupProfiler()->benchmarkWallet().isEmpty()) {
+        return;
+    }
+
     // Stagenet / Testnet
     auto worthlessWarning = QString("Feather wallet is currently running in %1 mode. This is meant "
                                     "for developers only. Your coins are WORTHLESS.");
@@ -269,6 +275,7 @@ void WindowManager::tryOpenWallet(const QString &path, const QString &password)
     }
 
     m_openingWallet = true;
+    startupProfiler()->mark(StartupProfiler::WalletOpenStarted);
     m_walletManager->openWalletAsync(path, password, constants::networkType, constants::kdfRounds, Utils::ringDatabasePath());
 }
 
@@ -347,6 +354,12 @@ void WindowManager::onWalletOpenPasswordRequired(bool invalidPassword, const QSt
 }
 
 bool WindowManager::autoOpenWallet() {
+    QString benchmarkPath = startupProfiler()->benchmarkWallet();
+    if (!benchmarkPath.isEmpty()) {
+        this->tryOpenWallet(benchmarkPath, "");
+        return true;
+    }
+
     QString autoPath = conf()->get(Config::autoOpenWalletPath).toString();
     if (!autoPath.isEmpty() && autoPath.startsWith(QString::number(constants::networkType))) {
         autoPath.remove(0, 1);
@@ -388,7 +401,7 @@ void WindowManager::tryCreateWallet(Seed seed, const QString &path, const QStrin
     wallet->setCacheAttribute("feather.seed", seed.mnemonic.join(" "));
     wallet->setCacheAttribute("feather.seedoffset", seedOffset);
     // Store attributes now, so we don't lose them on crash / forced exit
-    wallet->store();
+    wallet->storeNow();
 
     if (newWallet) {
         wallet->setNewWallet();
@@ -672,8 +685,11 @@ void WindowManager::onProxySettingsChanged() {
     }
 
     // Will kill the process if necessary
-    torManager()->init();
-    torManager()->start();
+    {
+        StartupProfiler::Span span("tor_start");
+        torManager()->init();
+        torManager()->start();
+    }
 
     QNetworkProxy proxy{QNetworkProxy::NoProxy};
     if (conf()->get(Config::proxy).toInt() != Config::Proxy::None) {
@@ -19,6 +19,9 @@ HistoryExportDialog::HistoryExportDialog(Wallet *wallet, QWidget *parent)
 {
     ui->setupUi(this);
 
+    // Nothing may have needed the history yet, it's built while the user picks a range
+    m_wallet->history()->load();
+
     connect(ui->btn_export, &QPushButton::clicked, this, &HistoryExportDialog::exportHistory);
 
     connect(ui->radio_everything, &QRadioButton::toggled, [this](bool toggled) {
@@ -74,6 +77,11 @@ void HistoryExportDialog::setEverything()
 
 void HistoryExportDialog::exportHistory()
 {
+    if (!m_wallet->history()->loaded()) {
+        Utils::showError(this, "Unable to export transaction history", "Transaction history is still loading", {"Try again in a moment"});
+        return;
+    }
+
     QString wallet_name = m_wallet->walletName();
     QString csv_file_name = QString("/history_export_%1.csv").arg(wallet_name);
 
@@ -160,7 +168,7 @@ void HistoryExportDialog::exportHistory()
              balanceDelta,
              tx.displayAmount(),
              tx.displayFee(),
-             tx.hash,
+             tx.hash(),
              tx.description,
              paymentId,
              fiatAmount,
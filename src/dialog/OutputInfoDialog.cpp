@@ -6,7 +6,7 @@
 
 #include "utils/Utils.h"
 
-OutputInfoDialog::OutputInfoDialog(const CoinsInfo &cInfo, QWidget *parent)
+OutputInfoDialog::OutputInfoDialog(const CoinsInfo &cInfo, const QString &address, QWidget *parent)
         : WindowModalDialog(parent)
         , ui(new Ui::OutputInfoDialog)
 {
@@ -18,10 +18,10 @@ OutputInfoDialog::OutputInfoDialog(const CoinsInfo &cInfo, QWidget *parent)
     ui->label_txid->setFont(font);
     ui->label_address->setFont(font);
 
-    ui->label_pubKey->setText(cInfo.pubKey);
-    ui->label_keyImage->setText(cInfo.keyImage);
-    ui->label_txid->setText(cInfo.hash);
-    ui->label_address->setText(cInfo.address);
+    ui->label_pubKey->setText(cInfo.pubKey());
+    ui->label_keyImage->setText(cInfo.keyImage());
+    ui->label_txid->setText(cInfo.hash());
+    ui->label_address->setText(address);
 
     QString status = cInfo.spent ? "spent" : (cInfo.frozen ? "frozen" : "unspent");
     ui->label_status->setText(status);
@@ -19,7 +19,7 @@ class OutputInfoDialog : public WindowModalDialog
 Q_OBJECT
 
 public:
-    explicit OutputInfoDialog(const CoinsInfo &cInfo, QWidget *parent = nullptr);
+    explicit OutputInfoDialog(const CoinsInfo &cInfo, const QString &address, QWidget *parent = nullptr);
     ~OutputInfoDialog() override;
 
 private:
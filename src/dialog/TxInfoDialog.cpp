@@ -29,7 +29,7 @@ TxInfoDialog::TxInfoDialog(Wallet *wallet, const TransactionRow &txInfo, QWidget
     ui->btn_viewOnBlockExplorer->setToolTip("View on block explorer");
     connect(ui->btn_viewOnBlockExplorer, &QPushButton::clicked, this, &TxInfoDialog::viewOnBlockExplorer);
 
-    m_txid = txInfo.hash;
+    m_txid = txInfo.hash();
     ui->label_txid->setText(m_txid);
 
     connect(ui->btn_copyTxID, &QPushButton::clicked, this, &TxInfoDialog::copyTxID);
@@ -73,7 +73,7 @@ TxInfoDialog::TxInfoDialog(Wallet *wallet, const TransactionRow &txInfo, QWidget
 
     QTextCursor cursor = ui->outputs->textCursor();
 
-    auto transfers = txInfo.transfers;
+    auto transfers = m_wallet->history()->transfers(txInfo);
     if (!transfers.isEmpty()) {
         bool hasIntegrated = false;
 
@@ -123,6 +123,7 @@ void TxInfoDialog::adjustHeight(QTextEdit *textEdit, qreal docHeight) {
 
 void TxInfoDialog::setData(const TransactionRow &tx) {
     QString blockHeight = QString::number(tx.blockHeight);
+    quint64 confirmations = tx.confirmations(m_wallet->blockChainHeight());
 
     if (tx.failed) {
         ui->label_status->setText("Status: Failed (node was unable to relay transaction)");
@@ -133,14 +134,14 @@ void TxInfoDialog::setData(const TransactionRow &tx) {
     else {
         QString dateTimeFormat = QString("%1 %2").arg(conf()->get(Config::dateFormat).toString(), conf()->get(Config::timeFormat).toString());
         QString date = tx.timestamp.toString(dateTimeFormat);
-        QString statusText = QString("Status: Included in block %1 (%2 confirmations) on %3").arg(blockHeight, QString::number(tx.confirmations), date);
+        QString statusText = QString("Status: Included in block %1 (%2 confirmations) on %3").arg(blockHeight, QString::number(confirmations), date);
         ui->label_status->setText(statusText);
     }
 
 
-    if (tx.confirmationsRequired() > tx.confirmations) {
+    if (tx.confirmationsRequired() > confirmations) {
         bool mandatoryLock = tx.confirmationsRequired() == 10;
-        QString confsRequired = QString::number(tx.confirmationsRequired() - tx.confirmations);
+        QString confsRequired = QString::number(tx.confirmationsRequired() - confirmations);
         ui->label_lock->setText(QString("Lock: Outputs become spendable in %1 blocks (%2)").arg(confsRequired, mandatoryLock ? "consensus rule" : "specified by sender"));
     } else {
         ui->label_lock->setText("Lock: Outputs are spendable");
@@ -167,7 +168,7 @@ void TxInfoDialog::updateData() {
     const auto& rows = m_wallet->history()->getRows();
     auto itr = std::find_if(rows.begin(), rows.end(),
             [&](const TransactionRow& ti) {
-        return ti.hash == m_txid;
+        return ti.hash() == m_txid;
     });
     if (itr == rows.end()) {
         return;
@@ -6,6 +6,7 @@
 
 #include <QMessageBox>
 
+#include "libwalletqt/TransactionHistory.h"
 #include "libwalletqt/rows/Output.h"
 #include "utils/Icons.h"
 #include "utils/Utils.h"
@@ -17,11 +18,11 @@ TxProofDialog::TxProofDialog(QWidget *parent, Wallet *wallet, const TransactionR
 {
     ui->setupUi(this);
 
-    m_txid = txInfo.hash;
+    m_txid = txInfo.hash();
 
     m_direction = txInfo.direction;
 
-    for (auto const &t: txInfo.transfers) {
+    for (auto const &t: m_wallet->history()->transfers(txInfo)) {
         m_OutDestinations.push_back(t.address);
     }
 
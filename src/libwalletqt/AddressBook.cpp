@@ -2,11 +2,13 @@
 // SPDX-FileCopyrightText: The Monero Project
 
 #include "AddressBook.h"
+#include "Wallet.h"
 
 #include <wallet/wallet2.h>
 
-AddressBook::AddressBook(tools::wallet2 *wallet2, QObject *parent)
+AddressBook::AddressBook(Wallet *wallet, tools::wallet2 *wallet2, QObject *parent)
     : QObject(parent)
+    , m_wallet(wallet)
     , m_wallet2(wallet2)
     , m_errorCode(Status_Ok)
 {
@@ -61,7 +63,11 @@ bool AddressBook::addRow(const QString &address, const QString &description)
         return false;
     }
 
-    bool r = m_wallet2->add_address_book_row(info.address, info.has_payment_id ? &info.payment_id : nullptr, description.toStdString(), info.is_subaddress);
+    bool r;
+    {
+        QMutexLocker locker(m_wallet->storeMutex());
+        r = m_wallet2->add_address_book_row(info.address, info.has_payment_id ? &info.payment_id : nullptr, description.toStdString(), info.is_subaddress);
+    }
     if (r)
         refresh();
     else
@@ -79,7 +85,11 @@ bool AddressBook::setDescription(qsizetype index, const QString &description) {
 
     tools::wallet2::address_book_row entry = ab[index];
     entry.m_description = description.toStdString();
-    bool r = m_wallet2->set_address_book_row(index, entry.m_address, entry.m_has_payment_id ? &entry.m_payment_id : nullptr, entry.m_description, entry.m_is_subaddress);
+    bool r;
+    {
+        QMutexLocker locker(m_wallet->storeMutex());
+        r = m_wallet2->set_address_book_row(index, entry.m_address, entry.m_has_payment_id ? &entry.m_payment_id : nullptr, entry.m_description, entry.m_is_subaddress);
+    }
     if (r)
         refresh();
     else
@@ -89,7 +99,11 @@ bool AddressBook::setDescription(qsizetype index, const QString &description) {
 
 bool AddressBook::deleteRow(qsizetype index)
 {
-    bool r = m_wallet2->delete_address_book_row(index);
+    bool r;
+    {
+        QMutexLocker locker(m_wallet->storeMutex());
+        r = m_wallet2->delete_address_book_row(index);
+    }
     if (r)
         refresh();
     return r;
@@ -49,9 +49,10 @@ signals:
     void refreshFinished() const;
 
 private:
-    explicit AddressBook(tools::wallet2 *wallet2, QObject *parent);
+    explicit AddressBook(Wallet *wallet, tools::wallet2 *wallet2, QObject *parent);
     friend class Wallet;
 
+    Wallet *m_wallet;
     tools::wallet2 *m_wallet2;
     QList<ContactRow> m_rows;
 
@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include "Balances.h"
+
+namespace {
+    quint64 subaddressKey(quint32 account, quint32 subaddress) {
+        return (quint64(account) << 32) | subaddress;
+    }
+}
+
+quint64 Balances::total(quint32 account) const {
+    return m_accounts.value(account).total + m_pendingAccounts.value(account);
+}
+
+quint64 Balances::unlocked(quint32 account) const {
+    auto it = m_accounts.constFind(account);
+    return it == m_accounts.constEnd() ? 0 : it->total - it->locked;
+}
+
+quint64 Balances::total(quint32 account, quint32 subaddress) const {
+    quint64 key = subaddressKey(account, subaddress);
+    return m_subaddresses.value(key).total + m_pendingSubaddresses.value(key);
+}
+
+quint64 Balances::unlocked(quint32 account, quint32 subaddress) const {
+    auto it = m_subaddresses.constFind(subaddressKey(account, subaddress));
+    return it == m_subaddresses.constEnd() ? 0 : it->total - it->locked;
+}
+
+quint64 Balances::totalAll() const {
+    return m_all.total + m_pendingAll;
+}
+
+quint64 Balances::unlockedAll() const {
+    return m_all.total - m_all.locked;
+}
+
+quint64 Balances::generation() const {
+    return m_generation;
+}
+
+void Balances::add(const CoinsInfo &coin) {
+    this->apply(m_accounts[coin.subaddrAccount], coin, true);
+    this->apply(m_subaddresses[subaddressKey(coin.subaddrAccount, coin.subaddrIndex)], coin, true);
+    this->apply(m_all, coin, true);
+}
+
+void Balances::remove(const CoinsInfo &coin) {
+    this->apply(m_accounts[coin.subaddrAccount], coin, false);
+    this->apply(m_subaddresses[subaddressKey(coin.subaddrAccount, coin.subaddrIndex)], coin, false);
+    this->apply(m_all, coin, false);
+}
+
+void Balances::setPending(const QHash<quint64, quint64> &pending) {
+    if (pending == m_pendingSubaddresses) {
+        return;
+    }
+    m_generation++;
+
+    m_pendingAccounts.clear();
+    m_pendingSubaddresses = pending;
+    m_pendingAll = 0;
+    for (auto it = pending.cbegin(); it != pending.cend(); ++it) {
+        m_pendingAccounts[quint32(it.key() >> 32)] += it.value();
+        m_pendingAll += it.value();
+    }
+}
+
+void Balances::setHeight(quint64 walletHeight) {
+    if (walletHeight <= m_height) {
+        return;
+    }
+    m_height = walletHeight;
+
+    // Only entries with locked coins have anything to do, a handful right after receiving
+    if (m_all.unlocks.isEmpty() || m_all.unlocks.firstKey() > walletHeight) {
+        return;
+    }
+    m_generation++;
+    for (Entry &entry : m_accounts) {
+        unlock(entry, walletHeight);
+    }
+    for (Entry &entry : m_subaddresses) {
+        unlock(entry, walletHeight);
+    }
+    unlock(m_all, walletHeight);
+}
+
+void Balances::clear(quint64 walletHeight) {
+    m_accounts.clear();
+    m_subaddresses.clear();
+    m_all = {};
+    m_pendingAccounts.clear();
+    m_pendingSubaddresses.clear();
+    m_pendingAll = 0;
+    m_height = walletHeight;
+    m_generation++;
+}
+
+void Balances::apply(Entry &entry, const CoinsInfo &coin, bool add) {
+    if (coin.spent || coin.frozen) {
+        return;
+    }
+    m_generation++;
+
+    if (add) {
+        entry.total += coin.amount;
+    } else {
+        entry.total -= coin.amount;
+    }
+
+    // Coins that unlocked before they were added never had an unlock entry, the same goes for
+    // entries that were already unlocked by setHeight()
+    if (coin.unlocked(m_height)) {
+        return;
+    }
+
+    quint64 &locked = entry.unlocks[coin.unlockHeight];
+    if (add) {
+        locked += coin.amount;
+        entry.locked += coin.amount;
+    } else {
+        locked -= coin.amount;
+        entry.locked -= coin.amount;
+    }
+    if (locked == 0) {
+        entry.unlocks.remove(coin.unlockHeight);
+    }
+}
+
+void Balances::unlock(Entry &entry, quint64 walletHeight) {
+    while (!entry.unlocks.isEmpty() && entry.unlocks.firstKey() <= walletHeight) {
+        entry.locked -= entry.unlocks.first();
+        entry.unlocks.erase(entry.unlocks.begin());
+    }
+}
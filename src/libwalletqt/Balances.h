@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#ifndef FEATHER_BALANCES_H
+#define FEATHER_BALANCES_H
+
+#include <QHash>
+#include <QMap>
+
+#include "rows/CoinsInfo.h"
+
+// Balances of every account and subaddress, kept up to date from coin changes instead of
+// walking all transfers like wallet2::balance() does.
+//
+// Matches wallet2's non-strict balance: unspent outputs that aren't frozen, plus change and
+// incoming amounts of transactions in the pool. Pending amounts are never unlocked.
+class Balances
+{
+public:
+    quint64 total(quint32 account) const;
+    quint64 unlocked(quint32 account) const;
+    quint64 total(quint32 account, quint32 subaddress) const;
+    quint64 unlocked(quint32 account, quint32 subaddress) const;
+    quint64 totalAll() const;
+    quint64 unlockedAll() const;
+
+    //! bumped whenever any balance changes, copies keep counting from where they were made
+    quint64 generation() const;
+
+    //! a coin has to be removed with the same state it was added with
+    void add(const CoinsInfo &coin);
+    void remove(const CoinsInfo &coin);
+
+    //! replaces all pending amounts, by (account << 32 | subaddress)
+    void setPending(const QHash<quint64, quint64> &pending);
+
+    //! unlocks coins up to walletHeight, the height never goes back without a clear()
+    void setHeight(quint64 walletHeight);
+    void clear(quint64 walletHeight);
+
+private:
+    struct Entry {
+        quint64 total = 0;
+        quint64 locked = 0;
+        QMap<quint64, quint64> unlocks; // unlock height -> amount that is still locked
+    };
+
+    void apply(Entry &entry, const CoinsInfo &coin, bool add);
+    static void unlock(Entry &entry, quint64 walletHeight);
+
+    QHash<quint32, Entry> m_accounts;
+    QHash<quint64, Entry> m_subaddresses; // (account << 32 | subaddress)
+    Entry m_all;
+
+    QHash<quint32, quint64> m_pendingAccounts;
+    QHash<quint64, quint64> m_pendingSubaddresses;
+    quint64 m_pendingAll = 0;
+
+    quint64 m_height = 0;
+    quint64 m_generation = 0;
+};
+
+#endif //FEATHER_BALANCES_H
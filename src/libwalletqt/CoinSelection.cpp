@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include "CoinSelection.h"
+
+CoinSelection::CoinSelection(QObject *parent)
+        : QObject(parent)
+{
+
+}
+
+bool CoinSelection::contains(const HexKey &keyImage) const {
+    return m_amounts.contains(keyImage);
+}
+
+bool CoinSelection::isEmpty() const {
+    return m_amounts.isEmpty();
+}
+
+qsizetype CoinSelection::count() const {
+    return m_amounts.size();
+}
+
+quint64 CoinSelection::amount() const {
+    return m_amount;
+}
+
+void CoinSelection::set(const QList<CoinsInfo> &coins) {
+    m_amounts.clear();
+    m_amounts.reserve(coins.size());
+    m_amount = 0;
+    for (const CoinsInfo &coin : coins) {
+        this->add(coin);
+    }
+    emit changed();
+}
+
+void CoinSelection::insert(const CoinsInfo &coin) {
+    if (this->add(coin)) {
+        emit changed();
+    }
+}
+
+void CoinSelection::remove(const HexKey &keyImage) {
+    auto it = m_amounts.find(keyImage);
+    if (it == m_amounts.end()) {
+        return;
+    }
+    m_amount -= it.value();
+    m_amounts.erase(it);
+    emit changed();
+}
+
+void CoinSelection::clear() {
+    if (m_amounts.isEmpty()) {
+        return;
+    }
+    m_amounts.clear();
+    m_amount = 0;
+    emit changed();
+}
+
+std::set<std::string> CoinSelection::keyImages() const {
+    std::set<std::string> result;
+    for (auto it = m_amounts.cbegin(); it != m_amounts.cend(); ++it) {
+        result.insert(it.key().toHex().toStdString());
+    }
+    return result;
+}
+
+void CoinSelection::prune(const QList<const CoinsInfo*> &coins) {
+    bool pruned = false;
+    for (const CoinsInfo *coin : coins) {
+        if (!coin->spent && !coin->frozen) {
+            continue;
+        }
+        auto it = m_amounts.find(coin->ki);
+        if (it == m_amounts.end()) {
+            continue;
+        }
+        m_amount -= it.value();
+        m_amounts.erase(it);
+        pruned = true;
+    }
+
+    if (pruned) {
+        emit changed();
+    }
+}
+
+bool CoinSelection::add(const CoinsInfo &coin) {
+    if (!coin.keyImageKnown || m_amounts.contains(coin.ki)) {
+        return false;
+    }
+    m_amounts.insert(coin.ki, coin.amount);
+    m_amount += coin.amount;
+    return true;
+}
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#ifndef FEATHER_COINSELECTION_H
+#define FEATHER_COINSELECTION_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+
+#include <set>
+#include <string>
+
+#include "rows/CoinsInfo.h"
+#include "rows/HexKey.h"
+
+// Coins picked for coin control, by key image. Transactions only spend from these while it is not empty.
+class CoinSelection : public QObject
+{
+    Q_OBJECT
+
+public:
+    bool contains(const HexKey &keyImage) const;
+    bool isEmpty() const;
+    qsizetype count() const;
+    //! sum of the selected amounts, kept up to date on every change
+    quint64 amount() const;
+
+    //! replaces the selection, coins without a known key image are skipped
+    void set(const QList<CoinsInfo> &coins);
+    void insert(const CoinsInfo &coin);
+    void remove(const HexKey &keyImage);
+    void clear();
+
+    //! hex key images in the form wallet2 expects
+    std::set<std::string> keyImages() const;
+
+signals:
+    void changed() const;
+
+private:
+    explicit CoinSelection(QObject *parent);
+    friend class Coins;
+
+    bool add(const CoinsInfo &coin);
+    //! drops coins that were spent or frozen elsewhere, called by Coins with the rows it changed
+    void prune(const QList<const CoinsInfo*> &coins);
+
+    QHash<HexKey, quint64> m_amounts; // key image -> amount
+    quint64 m_amount = 0;
+};
+
+#endif //FEATHER_COINSELECTION_H
@@ -0,0 +1,258 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include "CoinSelector.h"
+
+#include <QHash>
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+    // Branch and bound gives up after this many steps and falls back to a greedy selection
+    constexpr qsizetype maxTries = 100000;
+}
+
+QString CoinSelector::strategyName(Strategy strategy) {
+    switch (strategy) {
+        case MinimizeInputs:
+            return "Minimize inputs";
+        case MinimizeChange:
+            return "Minimize change";
+        case ConsolidateDust:
+            return "Consolidate dust";
+        case PrivacyAge:
+            return "Spend by age";
+        default:
+            return {};
+    }
+}
+
+QList<qsizetype> CoinSelector::select(const QList<CoinsInfo> &coins, const Params &params) {
+    if (params.target == 0 && params.strategy != ConsolidateDust) {
+        return {};
+    }
+
+    QList<Candidate> pool = candidates(coins, params);
+
+    switch (params.strategy) {
+        case MinimizeInputs:
+            return largestFirst(pool, params.target, params.maxInputs);
+        case MinimizeChange:
+            // Another output costs about as much as another input
+            return leastChange(pool, params.target, params.feePerInput, params.maxInputs);
+        case ConsolidateDust:
+            return smallestFirst(pool, params.target, params.maxInputs);
+        case PrivacyAge:
+            return byAge(pool, params.target, params.maxInputs);
+        default:
+            return {};
+    }
+}
+
+QList<CoinSelector::Candidate> CoinSelector::candidates(const QList<CoinsInfo> &coins, const Params &params) {
+    QList<Candidate> pool;
+    pool.reserve(coins.size());
+
+    for (qsizetype i = 0; i < coins.size(); ++i) {
+        const CoinsInfo &coin = coins[i];
+        if (!coin.keyImageKnown || coin.spent || coin.frozen || !coin.unlocked(params.walletHeight)) {
+            continue;
+        }
+        if (coin.amount <= params.feePerInput) {
+            continue;
+        }
+        quint64 age = params.walletHeight > coin.blockHeight ? params.walletHeight - coin.blockHeight : 0;
+        pool.append({coin.amount - params.feePerInput, age, i});
+    }
+
+    std::sort(pool.begin(), pool.end(), [](const Candidate &a, const Candidate &b) {
+        return a.value != b.value ? a.value > b.value : a.index < b.index;
+    });
+
+    return pool;
+}
+
+QList<qsizetype> CoinSelector::largestFirst(const QList<Candidate> &candidates, quint64 target, qsizetype maxInputs) {
+    quint64 sum = 0;
+    qsizetype count = 0;
+    while (count < candidates.size() && count < maxInputs && sum < target) {
+        sum += candidates[count++].value;
+    }
+    if (sum < target) {
+        return {};
+    }
+
+    // The last coin only has to cover what is still missing, swap it for the smallest one that does
+    quint64 missing = target - (sum - candidates[count - 1].value);
+    auto smallest = std::partition_point(candidates.cbegin() + count - 1, candidates.cend(), [missing](const Candidate &c) {
+        return c.value >= missing;
+    }) - 1;
+
+    QList<qsizetype> result;
+    result.reserve(count);
+    for (qsizetype i = 0; i < count - 1; ++i) {
+        result.append(candidates[i].index);
+    }
+    result.append(smallest->index);
+    return result;
+}
+
+QList<qsizetype> CoinSelector::smallestFirst(const QList<Candidate> &candidates, quint64 target, qsizetype maxInputs) {
+    QList<qsizetype> result;
+    quint64 sum = 0;
+    for (auto it = candidates.crbegin(); it != candidates.crend() && result.size() < maxInputs; ++it) {
+        if (target > 0 && sum >= target) {
+            break;
+        }
+        result.append(it->index);
+        sum += it->value;
+    }
+
+    if (target == 0) {
+        // Consolidating a single coin only costs a fee
+        return result.size() > 1 ? result : QList<qsizetype>{};
+    }
+    return sum >= target ? result : QList<qsizetype>{};
+}
+
+QList<qsizetype> CoinSelector::branchAndBound(const QList<Candidate> &candidates, quint64 target, quint64 tolerance, qsizetype maxInputs) {
+    // Depth first search over include / exclude of every coin, largest first.
+    // A branch is cut as soon as it overshoots target + tolerance or can't reach target anymore.
+    quint64 available = 0;
+    for (const Candidate &c : candidates) {
+        available += c.value;
+    }
+    if (available < target) {
+        return {};
+    }
+
+    QList<qsizetype> selection; // positions into candidates
+    QList<qsizetype> best;
+    quint64 bestWaste = std::numeric_limits<quint64>::max();
+    quint64 value = 0;
+
+    qsizetype position = 0;
+    for (qsizetype tries = 0; tries < maxTries; ++tries, ++position) {
+        bool backtrack = false;
+        if (value + available < target || value > target + tolerance) {
+            backtrack = true;
+        }
+        else if (value >= target) {
+            quint64 waste = value - target;
+            if (waste < bestWaste || (waste == bestWaste && selection.size() < best.size())) {
+                best = selection;
+                bestWaste = waste;
+            }
+            if (waste == 0) {
+                break;
+            }
+            backtrack = true;
+        }
+        else if (selection.size() >= maxInputs || position >= candidates.size()) {
+            backtrack = true;
+        }
+
+        if (backtrack) {
+            if (selection.isEmpty()) {
+                break;
+            }
+            // Coins skipped since the last included one are available again for the exclude branch
+            for (--position; position > selection.last(); --position) {
+                available += candidates[position].value;
+            }
+            value -= candidates[position].value;
+            selection.removeLast();
+        }
+        else {
+            const Candidate &c = candidates[position];
+            available -= c.value;
+            // Excluding a coin and then including one of the same value leads to the same sums
+            if (selection.isEmpty() || position - 1 == selection.last() || c.value != candidates[position - 1].value) {
+                selection.append(position);
+                value += c.value;
+            }
+        }
+    }
+
+    QList<qsizetype> result;
+    result.reserve(best.size());
+    for (qsizetype i : best) {
+        result.append(candidates[i].index);
+    }
+    return result;
+}
+
+QList<qsizetype> CoinSelector::leastChange(const QList<Candidate> &candidates, quint64 target, quint64 tolerance, qsizetype maxInputs) {
+    QList<qsizetype> exact = branchAndBound(candidates, target, tolerance, maxInputs);
+    if (!exact.isEmpty()) {
+        return exact;
+    }
+
+    // No combination within tolerance. Either the smallest coin that covers target on its own,
+    // or the coins below it, largest first.
+    auto larger = std::partition_point(candidates.cbegin(), candidates.cend(), [target](const Candidate &c) {
+        return c.value >= target;
+    });
+    QList<Candidate> smaller(larger, candidates.cend());
+    QList<qsizetype> combined = largestFirst(smaller, target, maxInputs);
+
+    if (larger == candidates.cbegin()) {
+        return combined;
+    }
+    const Candidate &single = *(larger - 1);
+    if (combined.isEmpty()) {
+        return {single.index};
+    }
+
+    QHash<qsizetype, quint64> values;
+    for (const Candidate &c : smaller) {
+        values.insert(c.index, c.value);
+    }
+    quint64 sum = 0;
+    for (qsizetype index : combined) {
+        sum += values.value(index);
+    }
+
+    return sum < single.value ? combined : QList<qsizetype>{single.index};
+}
+
+QList<qsizetype> CoinSelector::byAge(const QList<Candidate> &candidates, quint64 target, qsizetype maxInputs) {
+    // Buckets double in length with age: the last few blocks, the last day, week, month, ...
+    // Coins in a bucket keep the descending value order of candidates.
+    QList<QList<Candidate>> buckets;
+    for (const Candidate &c : candidates) {
+        qsizetype bucket = 64 - qCountLeadingZeroBits(c.age);
+        if (bucket >= buckets.size()) {
+            buckets.resize(bucket + 1);
+        }
+        buckets[bucket].append(c);
+    }
+
+    // The oldest bucket that covers target on its own
+    for (auto bucket = buckets.crbegin(); bucket != buckets.crend(); ++bucket) {
+        QList<qsizetype> result = largestFirst(*bucket, target, maxInputs);
+        if (!result.isEmpty()) {
+            return result;
+        }
+    }
+
+    // Otherwise as few buckets as possible, oldest first
+    QList<Candidate> merged;
+    for (auto bucket = buckets.crbegin(); bucket != buckets.crend(); ++bucket) {
+        if (bucket->isEmpty()) {
+            continue;
+        }
+        merged.append(*bucket);
+        std::sort(merged.begin(), merged.end(), [](const Candidate &a, const Candidate &b) {
+            return a.value != b.value ? a.value > b.value : a.index < b.index;
+        });
+        QList<qsizetype> result = largestFirst(merged, target, maxInputs);
+        if (!result.isEmpty()) {
+            return result;
+        }
+    }
+
+    return {};
+}
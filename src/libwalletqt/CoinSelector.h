@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#ifndef FEATHER_COINSELECTOR_H
+#define FEATHER_COINSELECTOR_H
+
+#include <QList>
+
+#include "rows/CoinsInfo.h"
+
+// Picks inputs for a target amount from the coins of an account.
+//
+// Coins are weighed by their effective value, their amount minus the fee of spending them. Coins
+// that cost more to spend than they are worth are never picked. Every strategy runs in
+// O(n log n) on the number of coins, branch and bound is capped at a fixed number of steps.
+class CoinSelector
+{
+public:
+    enum Strategy {
+        MinimizeInputs = 0, // largest coins first, the smallest transaction
+        MinimizeChange,     // an exact match if one exists, otherwise the least change
+        ConsolidateDust,    // smallest coins first, up to maxInputs if there is no target
+        PrivacyAge,         // spend coins of similar age together, oldest first
+        COUNT
+    };
+
+    struct Params {
+        Strategy strategy = MinimizeInputs;
+        quint64 target = 0;       // amount to cover, excluding the fee of the inputs
+        quint64 feePerInput = 0;  // fee added by one more input, see inputWeight
+        quint64 walletHeight = 0; // for lock state and coin age
+        qsizetype maxInputs = 100;
+    };
+
+    //! approximate weight in bytes of one CLSAG input with a ring of 16
+    static constexpr quint64 inputWeight = 700;
+
+    static QString strategyName(Strategy strategy);
+
+    //! indexes into coins, empty if the target can't be covered
+    static QList<qsizetype> select(const QList<CoinsInfo> &coins, const Params &params);
+
+private:
+    struct Candidate {
+        quint64 value; // effective value
+        quint64 age;   // blocks since the coin was received
+        qsizetype index;
+    };
+
+    static QList<Candidate> candidates(const QList<CoinsInfo> &coins, const Params &params);
+
+    // Candidates are sorted by descending value for all of these, results are indexes into the coins
+    static QList<qsizetype> largestFirst(const QList<Candidate> &candidates, quint64 target, qsizetype maxInputs);
+    static QList<qsizetype> smallestFirst(const QList<Candidate> &candidates, quint64 target, qsizetype maxInputs);
+    static QList<qsizetype> branchAndBound(const QList<Candidate> &candidates, quint64 target, quint64 tolerance, qsizetype maxInputs);
+    static QList<qsizetype> leastChange(const QList<Candidate> &candidates, quint64 target, quint64 tolerance, qsizetype maxInputs);
+    static QList<qsizetype> byAge(const QList<Candidate> &candidates, quint64 target, qsizetype maxInputs);
+};
+
+#endif //FEATHER_COINSELECTOR_H
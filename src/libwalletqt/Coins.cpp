@@ -4,62 +4,539 @@
 #include "Coins.h"
 #include "rows/CoinsInfo.h"
 #include "Wallet.h"
+
+#include <QSet>
 #include <wallet/wallet2.h>
 
+namespace {
+    // Unlock height of outputs with a timestamp lock that hasn't expired yet
+    constexpr quint64 timeLocked = std::numeric_limits<quint64>::max();
+}
+
 Coins::Coins(Wallet *wallet, tools::wallet2 *wallet2, QObject *parent)
         : QObject(parent)
         , m_wallet(wallet)
         , m_wallet2(wallet2)
+        , m_selection(new CoinSelection(this))
 {
 
 }
 
 void Coins::refresh()
+{
+    this->requestRows(false);
+}
+
+void Coins::reload()
+{
+    this->requestRows(true);
+}
+
+void Coins::requestRows(bool full)
 {
     qDebug() << Q_FUNC_INFO;
 
-    emit refreshStarted();
+    // Rows of all accounts are kept, switching accounts only swaps the visible list
+    quint32 account = m_wallet->currentSubaddressAccount();
+    if (account != m_account) {
+        if (m_scanned) {
+            emit refreshStarted();
+            m_accounts[m_account] = std::move(m_rows);
+            m_rows = m_accounts.take(account);
+            this->findLocked();
+            emit refreshFinished();
+        }
+        m_account = account;
+    }
 
+    // One build at a time, requests that arrive meanwhile are merged into a single follow-up
+    if (m_building) {
+        m_pendingRefresh = true;
+        m_pendingReload = m_pendingReload || full;
+        return;
+    }
+
+    Snapshot snapshot;
+    snapshot.full = full || !m_scanned;
+    snapshot.scannedTransfers = m_scannedTransfers;
+    snapshot.lastKey = m_lastKey;
+    snapshot.generation = m_generation;
+    snapshot.changes = m_changes;
+    if (!snapshot.full) {
+        // shared until the worker touches a row
+        snapshot.rows = m_accounts;
+        snapshot.rows.insert(m_account, m_rows);
+        snapshot.live = m_live;
+        snapshot.dirty = m_dirty;
+    }
+    m_dirty = false;
+    snapshot.balances = m_balances;
+
+    m_building = true;
+    bool scheduled = m_wallet->runAsync([this, snapshot]() mutable {
+        // Beware! This code does not run in the GUI thread.
+        this->buildRows(snapshot);
+
+        QMetaObject::invokeMethod(this, [this, snapshot = std::move(snapshot)]() mutable {
+            this->applyRows(std::move(snapshot));
+        }, Qt::QueuedConnection);
+    });
+
+    if (!scheduled) {
+        m_building = false;
+    }
+}
+
+void Coins::buildRows(Snapshot &snapshot)
+{
     boost::shared_lock<boost::shared_mutex> transfers_lock(m_wallet2->m_transfers_mutex);
 
-    m_rows.clear();
-    for (size_t i = 0; i < m_wallet2->get_num_transfer_details(); ++i)
+    // Transfers are only ever appended, a shorter list means a rescan or reorg
+    size_t numTransfers = m_wallet2->get_num_transfer_details();
+    snapshot.height = m_wallet2->get_blockchain_current_height();
+    if (numTransfers < snapshot.scannedTransfers) {
+        snapshot.full = true;
+    }
+    snapshot.balances.setHeight(snapshot.height);
+
+    // Transfers are detached from the end on a reorg, if the last known one is still there so are the others
+    if (!snapshot.full && snapshot.scannedTransfers > 0) {
+        const tools::wallet2::transfer_details &td = m_wallet2->get_transfer_details(snapshot.scannedTransfers - 1);
+        if (HexKey::fromPod(td.get_public_key()) != snapshot.lastKey) {
+            snapshot.full = true;
+        }
+    }
+
+    for (auto it = snapshot.rows.begin(); !snapshot.full && it != snapshot.rows.end(); ++it)
+    {
+        QList<CoinsInfo> &rows = it.value();
+
+        // Spent and settled rows only change on events that call markDirty(), don't look at them on every block
+        const QList<qsizetype> candidates = snapshot.live.value(it.key());
+        qsizetype count = snapshot.dirty ? rows.size() : candidates.size();
+        QList<qsizetype> &live = snapshot.live[it.key()];
+        live.clear();
+
+        for (qsizetype k = 0; k < count; ++k)
+        {
+            qsizetype i = snapshot.dirty ? k : candidates[k];
+            const CoinsInfo &row = std::as_const(rows)[i];
+            const tools::wallet2::transfer_details &td = m_wallet2->get_transfer_details(row.transferIndex);
+
+            // A reorg may have put a different output at this index
+            if (td.m_global_output_index != row.globalOutputIndex || td.m_internal_output_index != row.internalOutputIndex || td.m_amount != row.amount) {
+                snapshot.full = true;
+                break;
+            }
+
+            // Timestamp locks can't be expressed as a height, ask wallet2 until they expire
+            quint64 unlockHeight = row.unlockHeight;
+            if (unlockHeight == timeLocked && m_wallet2->is_transfer_unlocked(td)) {
+                unlockHeight = 0;
+            }
+
+            if (td.m_spent == row.spent && td.m_spent_height == row.spentHeight && td.m_frozen == row.frozen
+                && td.m_key_image_known == row.keyImageKnown && unlockHeight == row.unlockHeight) {
+                if (Coins::live(row)) {
+                    live.append(i);
+                }
+                continue;
+            }
+
+            snapshot.balances.remove(row);
+
+            CoinsInfo &ci = rows[i];
+            ci.spent = td.m_spent;
+            ci.spentHeight = td.m_spent_height;
+            ci.frozen = td.m_frozen;
+            if (td.m_key_image_known != ci.keyImageKnown) {
+                ci.keyImageKnown = td.m_key_image_known;
+                ci.ki = HexKey::fromPod(td.m_key_image);
+            }
+            ci.unlockHeight = unlockHeight;
+            snapshot.balances.add(ci);
+            snapshot.updated[it.key()].append(i);
+            if (Coins::live(ci)) {
+                live.append(i);
+            }
+        }
+    }
+
+    size_t first = snapshot.scannedTransfers;
+    if (snapshot.full) {
+        first = 0;
+        snapshot.rows.clear();
+        snapshot.updated.clear();
+        snapshot.live.clear();
+        snapshot.balances.clear(snapshot.height);
+    }
+
+    for (size_t i = first; i < numTransfers; ++i)
     {
         const tools::wallet2::transfer_details &td = m_wallet2->get_transfer_details(i);
+        quint32 account = td.m_subaddr_index.major;
 
-        if (td.m_subaddr_index.major != m_wallet->currentSubaddressAccount()) {
+        CoinsInfo row = this->makeRow(i);
+        snapshot.balances.add(row);
+        if (Coins::live(row)) {
+            snapshot.live[account].append(snapshot.rows.value(account).size() + snapshot.inserted.value(account).size());
+        }
+        if (snapshot.full) {
+            snapshot.rows[account].push_back(std::move(row));
+        } else {
+            snapshot.inserted[account].push_back(std::move(row));
+        }
+    }
+
+    snapshot.scannedTransfers = numTransfers;
+    snapshot.lastKey = numTransfers > 0 ? HexKey::fromPod(m_wallet2->get_transfer_details(numTransfers - 1).get_public_key()) : HexKey();
+
+    // Transactions in the pool aren't transfers yet, there are only ever a few of them
+    QHash<quint64, quint64> pending;
+    std::list<std::pair<crypto::hash, tools::wallet2::unconfirmed_transfer_details>> payments_out;
+    m_wallet2->get_unconfirmed_payments_out(payments_out);
+    for (const auto &payment : payments_out) {
+        const tools::wallet2::unconfirmed_transfer_details &utx = payment.second;
+        if (utx.m_state == tools::wallet2::unconfirmed_transfer_details::failed || utx.m_change == (uint64_t)-1) {
             continue;
         }
+        // Change always goes to the first subaddress of the account
+        pending[quint64(utx.m_subaddr_account) << 32] += utx.m_change;
+    }
+    std::list<std::pair<crypto::hash, tools::wallet2::pool_payment_details>> payments;
+    m_wallet2->get_unconfirmed_payments(payments);
+    for (const auto &payment : payments) {
+        const tools::wallet2::payment_details &pd = payment.second.m_pd;
+        pending[(quint64(pd.m_subaddr_index.major) << 32) | pd.m_subaddr_index.minor] += pd.m_amount;
+    }
+    snapshot.balances.setPending(pending);
+    transfers_lock.unlock();
 
-        CoinsInfo ci;
-        ci.blockHeight = td.m_block_height;
-        ci.hash = QString::fromStdString(epee::string_tools::pod_to_hex(td.m_txid));
-        ci.internalOutputIndex = td.m_internal_output_index;
-        ci.globalOutputIndex = td.m_global_output_index;
-        ci.spent = td.m_spent;
-        ci.frozen = td.m_frozen;
-        ci.spentHeight = td.m_spent_height;
-        ci.amount = td.m_amount;
-        ci.rct = td.m_rct;
-        ci.keyImageKnown = td.m_key_image_known;
-        ci.pkIndex = td.m_pk_index;
-        ci.subaddrIndex = td.m_subaddr_index.minor;
-        ci.subaddrAccount = td.m_subaddr_index.major;
-        ci.address = QString::fromStdString(m_wallet2->get_subaddress_as_str(td.m_subaddr_index)); // todo: this is expensive, cache maybe?
-        ci.addressLabel = QString::fromStdString(m_wallet2->get_subaddress_label(td.m_subaddr_index));
-        ci.txNote = QString::fromStdString(m_wallet2->get_tx_note(td.m_txid));
-        ci.keyImage = QString::fromStdString(epee::string_tools::pod_to_hex(td.m_key_image));
-        ci.unlockTime = td.m_tx.unlock_time;
-        ci.unlocked = m_wallet2->is_transfer_unlocked(td);
-        ci.pubKey = QString::fromStdString(epee::string_tools::pod_to_hex(td.get_public_key()));
-        ci.coinbase = td.m_tx.vin.size() == 1 && td.m_tx.vin[0].type() == typeid(cryptonote::txin_gen);
-        ci.description = m_wallet->getCacheAttribute(QString("coin.description:%1").arg(ci.pubKey));
-        ci.change = m_wallet2->is_change(td);
-
-        m_rows.push_back(ci);
-    }
-
-    emit refreshFinished();
+    for (auto &rows : snapshot.full ? snapshot.rows : snapshot.inserted) {
+        this->fillText(rows);
+    }
+}
+
+void Coins::applyRows(Snapshot snapshot)
+{
+    m_building = false;
+
+    if (snapshot.full) {
+        auto key = [](const CoinsInfo &ci) {
+            return ci.pk;
+        };
+        auto equal = [](const CoinsInfo &a, const CoinsInfo &b) {
+            return a.transferIndex == b.transferIndex && a.spent == b.spent && a.spentHeight == b.spentHeight
+                && a.frozen == b.frozen && a.keyImageKnown == b.keyImageKnown && a.ki == b.ki
+                && a.unlockHeight == b.unlockHeight && a.addressLabel == b.addressLabel && a.description == b.description
+                && a.txNote == b.txNote;
+        };
+
+        // Only the visible account is diffed, the others are replaced as a whole
+        QList<CoinsInfo> rows = snapshot.rows.take(m_account);
+        bool applied = applyRowDiff(m_rows, rows, key, equal,
+                                    [this](const RowDelta &delta) { emit rowsAboutToChange(delta); },
+                                    [this](const RowDelta &delta) { emit rowsChanged(delta); });
+        if (!applied) {
+            emit refreshStarted();
+            m_rows = std::move(rows);
+            emit refreshFinished();
+        }
+
+        m_accounts = std::move(snapshot.rows);
+        m_live = std::move(snapshot.live);
+        m_scanned = true;
+
+        if (!m_selection->isEmpty()) {
+            QList<const CoinsInfo*> coins;
+            for (const auto &ci : std::as_const(m_rows)) {
+                coins.append(&ci);
+            }
+            for (const auto &rows : std::as_const(m_accounts)) {
+                for (const auto &ci : rows) {
+                    coins.append(&ci);
+                }
+            }
+            m_selection->prune(coins);
+        }
+        m_scannedTransfers = snapshot.scannedTransfers;
+        m_lastKey = snapshot.lastKey;
+
+        m_height = snapshot.height;
+        this->findLocked();
+
+        m_builtChanges = snapshot.changes;
+        this->setBalances(std::move(snapshot.balances));
+    }
+    else if (snapshot.generation != m_generation) {
+        // Rows were edited while the worker held a copy, don't overwrite the edit
+        m_pendingRefresh = true;
+        m_dirty = m_dirty || snapshot.dirty;
+    }
+    else {
+        m_rows = snapshot.rows.take(m_account);
+        this->emitUpdated(snapshot.updated.value(m_account));
+
+        QList<CoinsInfo> inserted = snapshot.inserted.take(m_account);
+        if (!inserted.isEmpty()) {
+            RowDelta delta{RowDelta::Inserted, m_rows.size(), m_rows.size() + inserted.size() - 1};
+            emit rowsAboutToChange(delta);
+            m_rows.append(std::move(inserted));
+            emit rowsChanged(delta);
+
+            for (qsizetype i = delta.first; i <= delta.last; ++i) {
+                if (!m_rows[i].unlocked(m_height)) {
+                    m_locked.append(i);
+                }
+            }
+        }
+
+        m_accounts = std::move(snapshot.rows);
+        for (auto it = snapshot.inserted.begin(); it != snapshot.inserted.end(); ++it) {
+            m_accounts[it.key()].append(std::move(it.value()));
+        }
+        m_live = std::move(snapshot.live);
+
+        // Coins spent from another device or frozen meanwhile can't stay selected
+        if (!m_selection->isEmpty()) {
+            QList<const CoinsInfo*> coins;
+            for (auto it = snapshot.updated.cbegin(); it != snapshot.updated.cend(); ++it) {
+                const QList<CoinsInfo> &rows = it.key() == m_account ? m_rows : *m_accounts.constFind(it.key());
+                for (qsizetype i : it.value()) {
+                    coins.append(&rows[i]);
+                }
+            }
+            m_selection->prune(coins);
+        }
+
+        m_scannedTransfers = snapshot.scannedTransfers;
+        m_lastKey = snapshot.lastKey;
+        this->setHeight(snapshot.height);
+
+        m_builtChanges = snapshot.changes;
+        this->setBalances(std::move(snapshot.balances));
+    }
+
+    if (m_pendingRefresh) {
+        bool reload = m_pendingReload;
+        m_pendingRefresh = false;
+        m_pendingReload = false;
+        this->requestRows(reload);
+    }
+}
+
+CoinsInfo Coins::makeRow(size_t transferIndex)
+{
+    // Caller holds m_transfers_mutex, labels and notes are filled in by fillText()
+    const tools::wallet2::transfer_details &td = m_wallet2->get_transfer_details(transferIndex);
+
+    CoinsInfo ci;
+    ci.transferIndex = transferIndex;
+    ci.blockHeight = td.m_block_height;
+    ci.txid = HexKey::fromPod(td.m_txid);
+    ci.internalOutputIndex = td.m_internal_output_index;
+    ci.globalOutputIndex = td.m_global_output_index;
+    ci.spent = td.m_spent;
+    ci.frozen = td.m_frozen;
+    ci.spentHeight = td.m_spent_height;
+    ci.amount = td.m_amount;
+    ci.rct = td.m_rct;
+    ci.keyImageKnown = td.m_key_image_known;
+    ci.pkIndex = td.m_pk_index;
+    ci.subaddrIndex = td.m_subaddr_index.minor;
+    ci.subaddrAccount = td.m_subaddr_index.major;
+    ci.ki = HexKey::fromPod(td.m_key_image);
+    ci.unlockTime = td.m_tx.unlock_time;
+    ci.unlockHeight = this->unlockHeight(td.m_block_height, td.m_tx.unlock_time);
+    if (ci.unlockHeight == timeLocked && m_wallet2->is_transfer_unlocked(td)) {
+        ci.unlockHeight = 0;
+    }
+    ci.pk = HexKey::fromPod(td.get_public_key());
+    ci.coinbase = td.m_tx.vin.size() == 1 && td.m_tx.vin[0].type() == typeid(cryptonote::txin_gen);
+    ci.change = m_wallet2->is_change(td);
+    return ci;
+}
+
+void Coins::fillText(QList<CoinsInfo> &rows)
+{
+    // Labels, notes and descriptions are written by the GUI thread under the store mutex, which the transfers
+    // lock doesn't cover. Take it first, the writers lock in the same order.
+    QMutexLocker storeLocker(m_wallet->storeMutex());
+    boost::shared_lock<boost::shared_mutex> transfers_lock(m_wallet2->m_transfers_mutex);
+
+    for (auto &ci : rows) {
+        crypto::hash txid;
+        std::memcpy(txid.data, ci.txid.bytes.data(), sizeof(txid.data));
+
+        ci.addressLabel = QString::fromStdString(m_wallet2->get_subaddress_label({ci.subaddrAccount, ci.subaddrIndex}));
+        ci.txNote = QString::fromStdString(m_wallet2->get_tx_note(txid));
+        ci.description = m_wallet->getCacheAttribute(QString("coin.description:%1").arg(ci.pk.toHex()));
+    }
+}
+
+bool Coins::live(const CoinsInfo &row)
+{
+    // Rows that change during a normal refresh: spends get confirmed, pool spends fail, time locks expire.
+    // Key images of outputs received by hardware and view-only wallets are filled in later.
+    return !row.spent || row.spentHeight == 0 || !row.keyImageKnown || row.unlockHeight == timeLocked;
+}
+
+quint64 Coins::unlockHeight(quint64 blockHeight, quint64 unlockTime)
+{
+    // Mirrors wallet2::is_transfer_unlocked for height based locks
+    if (unlockTime >= CRYPTONOTE_MAX_BLOCK_NUMBER) {
+        return timeLocked;
+    }
+    return std::max<quint64>(blockHeight + CRYPTONOTE_DEFAULT_TX_SPENDABLE_AGE, unlockTime);
+}
+
+void Coins::setHeight(quint64 walletHeight)
+{
+    if (walletHeight == m_height) {
+        return;
+    }
+    m_height = walletHeight;
+
+    // Lock state is derived from the height at read time, only rows that unlock now look any different
+    QList<qsizetype> unlocked;
+    m_locked.removeIf([this, &unlocked](qsizetype i) {
+        if (m_rows[i].unlocked(m_height)) {
+            unlocked.append(i);
+            return true;
+        }
+        return false;
+    });
+
+    if (!unlocked.isEmpty()) {
+        RowDelta delta{RowDelta::Updated, unlocked.first(), unlocked.last()};
+        emit rowsAboutToChange(delta);
+        emit rowsChanged(delta);
+    }
+}
+
+void Coins::setBalances(Balances balances)
+{
+    bool changed = balances.generation() != m_balances.generation();
+    m_balances = std::move(balances);
+    if (changed) {
+        emit balancesChanged();
+    }
+}
+
+void Coins::findLocked()
+{
+    m_locked.clear();
+    for (qsizetype i = 0; i < m_rows.size(); ++i) {
+        if (!m_rows[i].unlocked(m_height)) {
+            m_locked.append(i);
+        }
+    }
+}
+
+QString Coins::address(const CoinsInfo &coin)
+{
+    // Rows only keep the subaddress index, deriving the address is expensive and most outputs go to a handful of them
+    quint32 accountIndex = coin.subaddrAccount;
+    quint32 subaddressIndex = coin.subaddrIndex;
+    quint64 key = (quint64(accountIndex) << 32) | subaddressIndex;
+    auto it = m_addresses.constFind(key);
+    if (it != m_addresses.constEnd()) {
+        return it.value();
+    }
+
+    QString address = QString::fromStdString(m_wallet2->get_subaddress_as_str({accountIndex, subaddressIndex}));
+    m_addresses.insert(key, address);
+    return address;
+}
+
+void Coins::emitUpdated(const QList<qsizetype> &rows)
+{
+    // rows must be sorted, consecutive rows are reported as one range
+    for (qsizetype begin = 0; begin < rows.size();) {
+        qsizetype end = begin;
+        while (end + 1 < rows.size() && rows[end + 1] == rows[end] + 1) {
+            end++;
+        }
+
+        RowDelta delta{RowDelta::Updated, rows[begin], rows[end]};
+        emit rowsAboutToChange(delta);
+        emit rowsChanged(delta);
+        begin = end + 1;
+    }
+}
+
+void Coins::refreshLabels(quint32 accountIndex, quint32 subaddressIndex)
+{
+    QString label = QString::fromStdString(m_wallet2->get_subaddress_label({accountIndex, subaddressIndex}));
+
+    QList<qsizetype> updated;
+    bool edited = false;
+    if (accountIndex == m_account) {
+        for (qsizetype i = 0; i < m_rows.size(); ++i) {
+            CoinsInfo &ci = m_rows[i];
+            if (ci.subaddrIndex == subaddressIndex && ci.addressLabel != label) {
+                ci.addressLabel = label;
+                updated.append(i);
+            }
+        }
+        edited = !updated.isEmpty();
+    }
+    else {
+        auto it = m_accounts.find(accountIndex);
+        if (it != m_accounts.end()) {
+            for (auto &ci : it.value()) {
+                if (ci.subaddrIndex == subaddressIndex && ci.addressLabel != label) {
+                    ci.addressLabel = label;
+                    edited = true;
+                }
+            }
+        }
+    }
+
+    if (edited) {
+        m_generation++;
+    }
+
+    this->emitUpdated(updated);
+}
+
+void Coins::refreshNotes(const QSet<HexKey> &txids)
+{
+    QHash<HexKey, QString> notes;
+    for (const HexKey &txid : txids) {
+        crypto::hash hash;
+        std::memcpy(hash.data, txid.bytes.data(), sizeof(hash.data));
+        notes.insert(txid, QString::fromStdString(m_wallet2->get_tx_note(hash)));
+    }
+
+    // One pass over the coins however many notes changed
+    auto apply = [&notes](CoinsInfo &ci) {
+        auto note = notes.constFind(ci.txid);
+        if (note == notes.constEnd() || ci.txNote == *note) {
+            return false;
+        }
+        ci.txNote = *note;
+        return true;
+    };
+
+    QList<qsizetype> updated;
+    for (qsizetype i = 0; i < m_rows.size(); ++i) {
+        if (apply(m_rows[i])) {
+            updated.append(i);
+        }
+    }
+
+    bool edited = !updated.isEmpty();
+    for (auto &rows : m_accounts) {
+        for (auto &ci : rows) {
+            edited = apply(ci) || edited;
+        }
+    }
+
+    if (edited) {
+        m_generation++;
+    }
+    this->emitUpdated(updated);
 }
 
 quint64 Coins::count() const
@@ -80,10 +557,65 @@ const QList<CoinsInfo>& Coins::getRows()
     return m_rows;
 }
 
+quint64 Coins::height() const
+{
+    return m_height;
+}
+
+bool Coins::scanned() const
+{
+    return m_scanned;
+}
+
+const Balances& Coins::balances() const
+{
+    return m_balances;
+}
+
+void Coins::invalidate()
+{
+    m_changes++;
+}
+
+bool Coins::current() const
+{
+    return m_scanned && m_builtChanges == m_changes;
+}
+
+void Coins::markDirty()
+{
+    m_dirty = true;
+}
+
 void Coins::setDescription(const QString &publicKey, quint32 accountIndex, const QString &description)
 {
     m_wallet->setCacheAttribute(QString("coin.description:%1").arg(publicKey), description);
-    this->refresh();
+
+    HexKey pk = HexKey::fromHex(publicKey);
+
+    QList<qsizetype> updated;
+    for (qsizetype i = 0; i < m_rows.size(); ++i) {
+        if (m_rows[i].pk == pk) {
+            m_rows[i].description = description;
+            updated.append(i);
+        }
+    }
+
+    bool edited = !updated.isEmpty();
+    for (auto &rows : m_accounts) {
+        for (auto &ci : rows) {
+            if (ci.pk == pk) {
+                ci.description = description;
+                edited = true;
+            }
+        }
+    }
+
+    if (edited) {
+        m_generation++;
+    }
+    this->emitUpdated(updated);
+
     emit descriptionChanged();
 }
 
@@ -100,6 +632,7 @@ void Coins::freeze(QStringList &publicKeys)
 
         try
         {
+            QMutexLocker locker(m_wallet->storeMutex());
             m_wallet2->freeze(pk);
         }
         catch (const std::exception& e)
@@ -108,6 +641,8 @@ void Coins::freeze(QStringList &publicKeys)
         }
     }
 
+    this->invalidate();
+    this->markDirty();
     refresh();
 }
 
@@ -124,6 +659,7 @@ void Coins::thaw(QStringList &publicKeys)
 
         try
         {
+            QMutexLocker locker(m_wallet->storeMutex());
             m_wallet2->thaw(pk);
         }
         catch (const std::exception& e)
@@ -132,22 +668,11 @@ void Coins::thaw(QStringList &publicKeys)
         }
     }
 
+    this->invalidate();
+    this->markDirty();
     refresh();
 }
 
-quint64 Coins::sumAmounts(const QStringList &keyImages) {
-    quint64 amount = 0;
-    for (const CoinsInfo& coin : m_rows) {
-        if (!coin.keyImageKnown) {
-            continue;
-        }
-
-        if (!keyImages.contains(coin.keyImage)) {
-            continue;
-        }
-
-        amount += coin.amount;
-    }
-
-    return amount;
+CoinSelection* Coins::selection() const {
+    return m_selection;
 }
@@ -6,7 +6,13 @@
 
 #include <QObject>
 #include <QList>
-#include <QReadWriteLock>
+#include <QHash>
+#include <QSet>
+
+#include "Balances.h"
+#include "CoinSelection.h"
+#include "rows/CoinsInfo.h"
+#include "rows/RowDelta.h"
 
 namespace Monero {
     struct TransactionHistory;
@@ -16,36 +22,117 @@ namespace tools {
     class wallet2;
 }
 
-class CoinsInfo;
 class Wallet;
 class Coins : public QObject
 {
 Q_OBJECT
 
 public:
+    //! picks up new transfers and state changes of known ones, see rowsAboutToChange/rowsChanged
+    //! rows are built on a worker thread, this returns immediately
     void refresh();
+    //! rebuilds all rows, the model only sees the rows that differ
+    void reload();
     quint64 count() const;
 
     const CoinsInfo& getRow(qsizetype i);
     const QList<CoinsInfo>& getRows();
+    //! wallet height the rows were last refreshed at, lock state is relative to it
+    quint64 height() const;
+    //! false until the first refresh finished, balances() is empty until then
+    bool scanned() const;
+    //! balances of all accounts as of the last refresh
+    const Balances& balances() const;
+    //! wallet2 moved on, balances() lags behind it until a refresh started after this call finished
+    void invalidate();
+    //! scanned, and not invalidated since the last applied refresh was started
+    bool current() const;
+    //! the next refresh() compares every row with wallet2, otherwise only rows that may still change are
+    //! called after anything that changes spent or settled transfers: reorgs, imports, rescans, freezing
+    void markDirty();
 
     void setDescription(const QString &publicKey, quint32 accountIndex, const QString &description);
     void freeze(QStringList &publicKeys);
     void thaw(QStringList &publicKeys);
-    quint64 sumAmounts(const QStringList &keyImages);
+    void refreshLabels(quint32 accountIndex, quint32 subaddressIndex);
+    void refreshNotes(const QSet<HexKey> &txids);
+    QString address(const CoinsInfo &coin);
+
+    //! coins picked for coin control
+    CoinSelection* selection() const;
 
 signals:
+    // Emitted around a full reset, when reload() could not diff the rows
     void refreshStarted() const;
     void refreshFinished() const;
     void descriptionChanged() const;
+    void balancesChanged() const;
+
+    // Emitted around each change applied by refresh(), rows are not touched in between
+    void rowsAboutToChange(const RowDelta &delta) const;
+    void rowsChanged(const RowDelta &delta) const;
 
 private:
     explicit Coins(Wallet *wallet, tools::wallet2 *wallet2, QObject *parent = nullptr);
     friend class Wallet;
 
+    // Handed to the worker and back, everything it needs to build rows without touching members
+    struct Snapshot {
+        bool full = false;                      // rows replaces everything
+        bool dirty = false;                     // incremental: compare all rows, not only the live ones
+        size_t scannedTransfers = 0;
+        HexKey lastKey;                         // public key of transfer scannedTransfers - 1
+        quint64 generation = 0;
+        quint64 changes = 0;                    // m_changes when the build was requested
+        quint64 height = 0;
+        QHash<quint32, QList<CoinsInfo>> rows;  // by account, incremental: the current rows, with updates applied
+        QHash<quint32, QList<qsizetype>> updated;
+        QHash<quint32, QList<CoinsInfo>> inserted;
+        QHash<quint32, QList<qsizetype>> live;  // by account, positions in rows followed by inserted
+        Balances balances;                      // the current balances, with updates applied
+    };
+
+    void requestRows(bool full);
+    void buildRows(Snapshot &snapshot);
+    void applyRows(Snapshot snapshot);
+
+    CoinsInfo makeRow(size_t transferIndex);
+    static bool live(const CoinsInfo &row);
+    void fillText(QList<CoinsInfo> &rows);
+    static quint64 unlockHeight(quint64 blockHeight, quint64 unlockTime);
+    void setHeight(quint64 walletHeight);
+    void findLocked();
+    void setBalances(Balances balances);
+    void emitUpdated(const QList<qsizetype> &rows);
+
     Wallet *m_wallet;
     tools::wallet2 *m_wallet2;
-    QList<CoinsInfo> m_rows;
+    CoinSelection *m_selection;
+    QList<CoinsInfo> m_rows; // only touched on the GUI thread, workers hand over whole lists
+    QHash<quint32, QList<CoinsInfo>> m_accounts; // rows of the other accounts, by account index
+
+    // Transfers below m_scannedTransfers are already represented in m_rows
+    bool m_scanned = false;
+    size_t m_scannedTransfers = 0;
+    HexKey m_lastKey;
+    quint32 m_account = 0; // account shown in m_rows
+
+    quint64 m_height = 0;
+    QList<qsizetype> m_locked; // visible rows that are not spendable yet, ascending
+    Balances m_balances;
+    quint64 m_changes = 0;      // bumped by invalidate()
+    quint64 m_builtChanges = 0; // m_changes of the snapshot m_balances came from
+
+    // Rows whose wallet2 state may change without markDirty(), see live(). Only these are compared by refresh().
+    QHash<quint32, QList<qsizetype>> m_live; // by account, ascending
+    bool m_dirty = false;
+
+    bool m_building = false;
+    bool m_pendingRefresh = false;
+    bool m_pendingReload = false;
+    quint64 m_generation = 0; // bumped when rows are edited in place
+
+    QHash<quint64, QString> m_addresses; // (account << 32 | index) -> address
 };
 
 #endif //FEATHER_COINS_H
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include "RefreshCoalescer.h"
+
+RefreshCoalescer::RefreshCoalescer(int intervalMs, QObject *parent)
+        : QObject(parent)
+        , m_timer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(intervalMs);
+    connect(m_timer, &QTimer::timeout, this, &RefreshCoalescer::flush);
+}
+
+void RefreshCoalescer::schedule() {
+    m_pending = true;
+
+    // Don't restart a running timer, a steady stream of blocks must not postpone the update forever
+    if (!m_timer->isActive()) {
+        m_timer->start();
+    }
+}
+
+void RefreshCoalescer::flush() {
+    m_timer->stop();
+
+    if (!m_pending) {
+        return;
+    }
+    m_pending = false;
+
+    emit refresh();
+}
+
+bool RefreshCoalescer::isPending() const {
+    return m_pending;
+}
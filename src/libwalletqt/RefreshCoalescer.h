@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#ifndef FEATHER_REFRESHCOALESCER_H
+#define FEATHER_REFRESHCOALESCER_H
+
+#include <QObject>
+#include <QTimer>
+
+// Folds bursts of refresh requests into one refresh per interval.
+//
+// The first request starts the interval and later ones join it instead of restarting it, a steady
+// stream of requests still refreshes once per interval. flush() refreshes right away if anything
+// was requested.
+class RefreshCoalescer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RefreshCoalescer(int intervalMs, QObject *parent = nullptr);
+
+    void schedule();
+    void flush();
+    bool isPending() const;
+
+signals:
+    void refresh();
+
+private:
+    QTimer *m_timer;
+    bool m_pending = false;
+};
+
+#endif //FEATHER_REFRESHCOALESCER_H
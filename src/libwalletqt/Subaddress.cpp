@@ -3,19 +3,28 @@
 
 #include "Subaddress.h"
 
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+
 #include "Wallet.h"
 #include <wallet/wallet2.h>
 
+namespace {
+    // Subaddresses derived per job, a few milliseconds of work each
+    constexpr quint32 deriveChunkSize = 256;
+}
+
 Subaddress::Subaddress(Wallet *wallet, tools::wallet2 *wallet2, QObject *parent)
     : QObject(parent)
     , m_wallet(wallet)
     , m_wallet2(wallet2)
 {
-    QString pinned = m_wallet->getCacheAttribute("feather.pinnedaddresses");
-    m_pinned = pinned.split(",");
+    QStringList pinned = m_wallet->getCacheAttribute("feather.pinnedaddresses").split(",", Qt::SkipEmptyParts);
+    m_pinned = QSet<QString>(pinned.cbegin(), pinned.cend());
 
-    QString hidden = m_wallet->getCacheAttribute("feather.hiddenaddresses");
-    m_hidden = hidden.split(",");
+    QStringList hidden = m_wallet->getCacheAttribute("feather.hiddenaddresses").split(",", Qt::SkipEmptyParts);
+    m_hidden = QSet<QString>(hidden.cbegin(), hidden.cend());
 
     connect(this, &Subaddress::noUnusedSubaddresses, [this] {
         this->addRow("");
@@ -24,56 +33,165 @@ Subaddress::Subaddress(Wallet *wallet, tools::wallet2 *wallet2, QObject *parent)
 
 bool Subaddress::refresh()
 {
-    emit refreshStarted();
-
-    m_rows.clear();
-
-    bool potentialWalletFileCorruption = false;
-
     quint32 accountIndex = m_wallet->currentSubaddressAccount();
-    for (quint32 i = 0; i < m_wallet2->get_num_subaddresses(accountIndex); ++i)
-    {
-        bool r = emplaceRow(i);
-        if (!r) {
-            potentialWalletFileCorruption = true;
-            break;
+
+    // Rows are built from m_used, catch up on transfers first
+    QSet<quint32> used;
+    this->scanTransfers(used);
+
+    // Rows of accounts we've shown before are kept, switching back doesn't derive them again
+    if (accountIndex != m_account) {
+        emit refreshStarted();
+        m_accounts[m_account] = std::move(m_rows);
+        m_rows = m_accounts.take(accountIndex);
+        m_account = accountIndex;
+        emit refreshFinished();
+
+        if (!m_rows.isEmpty() && m_rows.size() == m_wallet2->get_num_subaddresses(accountIndex)) {
+            // Transfers scanned while the account was hidden haven't touched its rows yet
+            this->syncUsed();
+            if (m_unused == 0) {
+                emit noUnusedSubaddresses();
+            }
+            return true;
         }
     }
 
+    QList<SubaddressRow> rows;
+
+    bool software = m_wallet2->get_device_type() == hw::device::SOFTWARE;
+
     // Make sure keys are intact. We NEVER want to display incorrect addresses in case of memory corruption.
-    potentialWalletFileCorruption = potentialWalletFileCorruption || (m_wallet2->get_device_type() == hw::device::SOFTWARE && !m_wallet2->verify_keys());
+    QFuture<bool> keysVerified;
+    if (software) {
+        keysVerified = QtConcurrent::run([this]{
+            return m_wallet2->verify_keys();
+        });
+    }
+
+    bool potentialWalletFileCorruption = !this->deriveRows(rows, accountIndex, m_wallet2->get_num_subaddresses(accountIndex), software);
+
+    potentialWalletFileCorruption = potentialWalletFileCorruption || (software && !keysVerified.result());
 
     if (potentialWalletFileCorruption) {
         LOG_ERROR("KEY INCONSISTENCY DETECTED, WALLET IS IN CORRUPT STATE.");
+        emit refreshStarted();
         m_rows.clear();
+        m_accounts.clear();
+        m_unused = 0;
+        emit refreshFinished();
         emit corrupted();
+        return false;
     }
 
-    emit refreshFinished();
+    auto key = [](const SubaddressRow &row) {
+        return row.address;
+    };
+    auto equal = [](const SubaddressRow &a, const SubaddressRow &b) {
+        return a.label == b.label && a.used == b.used && a.hidden == b.hidden && a.pinned == b.pinned;
+    };
+
+    bool applied = applyRowDiff(m_rows, rows, key, equal,
+                                [this](const RowDelta &delta) { emit rowsAboutToChange(delta); },
+                                [this](const RowDelta &delta) { emit rowsChanged(delta); });
+    if (!applied) {
+        emit refreshStarted();
+        m_rows = std::move(rows);
+        emit refreshFinished();
+    }
+    this->countUnused();
 
-    return !potentialWalletFileCorruption;
+    return true;
 }
 
 void Subaddress::updateUsed(quint32 accountIndex)
 {
-    bool haveUnused = false;
-    for (quint32 i = 0; i < m_rows.count(); i++) {
-        SubaddressRow& row = m_rows[i];
+    QSet<quint32> used;
+    bool rescanned = this->scanTransfers(used);
 
-        bool used = m_wallet2->get_subaddress_used({accountIndex, i});
-        if (used != row.used) {
-            row.used = !row.used;
-            emit rowUpdated(i);
+    if (accountIndex == m_account) {
+        if (rescanned) {
+            // A reorg or rescan may have taken outputs away
+            this->syncUsed();
         }
-        if (!used && i > 0) {
-            haveUnused = true;
+        else {
+            for (quint32 i : used) {
+                if (qsizetype(i) >= m_rows.size() || m_rows[i].used) {
+                    continue;
+                }
+                m_rows[i].used = true;
+                if (i > 0) {
+                    m_unused--;
+                }
+                emit rowUpdated(i);
+            }
         }
     }
-    if (!haveUnused) {
+
+    if (m_unused == 0) {
         emit noUnusedSubaddresses();
     }
 }
 
+bool Subaddress::scanTransfers(QSet<quint32> &used)
+{
+    // Returns true if everything was scanned again, used then holds nothing.
+    // Otherwise used holds the subaddresses of the current account that received their first output.
+    boost::shared_lock<boost::shared_mutex> transfers_lock(m_wallet2->m_transfers_mutex, boost::try_to_lock);
+    if (!transfers_lock.owns_lock()) {
+        // The refresh thread is busy with a block, the next call picks up where this one would have
+        return false;
+    }
+
+    // Transfers are only ever appended, unless a rescan or reorg detached the tail. The new chain may
+    // have added as many transfers back by now, so the count alone doesn't tell.
+    size_t numTransfers = m_wallet2->get_num_transfer_details();
+    bool rescanned = numTransfers < m_scannedTransfers
+            || (m_scannedTransfers > 0 && HexKey::fromPod(m_wallet2->get_transfer_details(m_scannedTransfers - 1).get_public_key()) != m_lastKey);
+    if (rescanned) {
+        m_used.clear();
+        m_scannedTransfers = 0;
+    }
+
+    for (size_t i = m_scannedTransfers; i < numTransfers; ++i) {
+        const cryptonote::subaddress_index &index = m_wallet2->get_transfer_details(i).m_subaddr_index;
+        QSet<quint32> &accountUsed = m_used[index.major];
+        if (!accountUsed.contains(index.minor)) {
+            accountUsed.insert(index.minor);
+            if (index.major == m_account) {
+                used.insert(index.minor);
+            }
+        }
+    }
+    m_scannedTransfers = numTransfers;
+    m_lastKey = numTransfers > 0 ? HexKey::fromPod(m_wallet2->get_transfer_details(numTransfers - 1).get_public_key()) : HexKey();
+
+    return rescanned;
+}
+
+void Subaddress::syncUsed()
+{
+    const QSet<quint32> accountUsed = m_used.value(m_account);
+    for (qsizetype i = 0; i < m_rows.size(); i++) {
+        bool used = accountUsed.contains(i);
+        if (used != m_rows[i].used) {
+            m_rows[i].used = used;
+            emit rowUpdated(i);
+        }
+    }
+    this->countUnused();
+}
+
+void Subaddress::countUnused()
+{
+    m_unused = 0;
+    for (qsizetype i = 1; i < m_rows.size(); i++) {
+        if (!m_rows[i].used) {
+            m_unused++;
+        }
+    }
+}
+
 qsizetype Subaddress::count() const
 {
     return m_rows.length();
@@ -97,30 +215,91 @@ const QList<SubaddressRow>& Subaddress::getRows()
     return m_rows;
 }
 
-bool Subaddress::emplaceRow(quint32 addressIndex)
+QString Subaddress::deriveAddress(const cryptonote::subaddress_index &index) const
 {
-    cryptonote::subaddress_index index = {m_wallet->currentSubaddressAccount(), addressIndex};
+    // Returns an empty string if the address doesn't map back to index
     cryptonote::account_public_address address = m_wallet2->get_subaddress(index);
 
     // Make sure we have previously generated Di
     auto idx =  m_wallet2->get_subaddress_index(address);
     if (!idx) {
-        return false;
+        return {};
     }
 
     // Verify mapping
     if (idx != index) {
-        return false;
+        return {};
+    }
+
+    return QString::fromStdString(cryptonote::get_account_address_as_str(m_wallet2->nettype(), !index.is_zero(), address));
+}
+
+bool Subaddress::deriveRows(QList<SubaddressRow> &rows, quint32 accountIndex, quint32 count, bool parallel)
+{
+    // Deriving and encoding addresses dominates, it is spread over the thread pool in chunks.
+    // Wallet2 is only read here, the GUI thread waits for all chunks before it touches it again.
+    QList<QString> addresses(count);
+    QString *out = addresses.data();
+
+    QList<QPair<quint32, quint32>> chunks;
+    for (quint32 first = 0; first < count; first += deriveChunkSize) {
+        chunks.append({first, std::min(count, first + deriveChunkSize)});
+    }
+
+    auto derive = [this, accountIndex, out](const QPair<quint32, quint32> &chunk) {
+        for (quint32 i = chunk.first; i < chunk.second; ++i) {
+            out[i] = this->deriveAddress({accountIndex, i});
+            if (out[i].isEmpty()) {
+                return;
+            }
+        }
+    };
+
+    // Hardware devices are talked to one request at a time
+    if (parallel && chunks.size() > 1) {
+        QtConcurrent::blockingMap(chunks, derive);
+    } else {
+        for (const auto &chunk : chunks) {
+            derive(chunk);
+        }
     }
 
-    if (m_rows.length() != addressIndex) {
+    const QSet<quint32> accountUsed = m_used.value(accountIndex);
+    rows.reserve(count);
+    for (quint32 i = 0; i < count; ++i) {
+        const QString &address = addresses[i];
+        if (address.isEmpty()) {
+            return false;
+        }
+
+        cryptonote::subaddress_index index = {accountIndex, i};
+        rows.emplace_back(
+            address,
+            QString::fromStdString(m_wallet2->get_subaddress_label(index)),
+            accountUsed.contains(i),
+            this->isHidden(address),
+            this->isPinned(address),
+            index.is_zero()
+        );
+    }
+    return true;
+}
+
+bool Subaddress::emplaceRow(QList<SubaddressRow> &rows, quint32 addressIndex)
+{
+    cryptonote::subaddress_index index = {m_wallet->currentSubaddressAccount(), addressIndex};
+
+    if (rows.length() != addressIndex) {
         return false;
     }
 
-    QString addressStr = QString::fromStdString(cryptonote::get_account_address_as_str(m_wallet2->nettype(), !index.is_zero(), address));
+    QString addressStr = this->deriveAddress(index);
+    if (addressStr.isEmpty()) {
+        return false;
+    }
 
-    bool used = m_wallet2->get_subaddress_used(index);
-    m_rows.emplace_back(
+    bool used = m_used.value(index.major).contains(index.minor);
+    rows.emplace_back(
         addressStr,
         QString::fromStdString(m_wallet2->get_subaddress_label(index)),
         used,
@@ -138,10 +317,16 @@ bool Subaddress::addRow(const QString &label)
     try
     {
         quint32 addressIndex = m_wallet->numSubaddresses(m_wallet->currentSubaddressAccount());
-        m_wallet2->add_subaddress(m_wallet->currentSubaddressAccount(), label.toStdString());
+        {
+            QMutexLocker locker(m_wallet->storeMutex());
+            m_wallet2->add_subaddress(m_wallet->currentSubaddressAccount(), label.toStdString());
+        }
 
         emit beginAddRow(addressIndex);
-        emplaceRow(addressIndex);
+        emplaceRow(m_rows, addressIndex);
+        if (addressIndex > 0 && addressIndex < m_rows.size() && !m_rows[addressIndex].used) {
+            m_unused++;
+        }
         emit endAddRow();
     }
     catch (const std::exception& e)
@@ -158,7 +343,10 @@ bool Subaddress::addRow(const QString &label)
 bool Subaddress::setLabel(quint32 addressIndex, const QString &label)
 {
     try {
-        m_wallet2->set_subaddress_label({m_wallet->currentSubaddressAccount(), addressIndex}, label.toStdString());
+        {
+            QMutexLocker locker(m_wallet->storeMutex());
+            m_wallet2->set_subaddress_label({m_wallet->currentSubaddressAccount(), addressIndex}, label.toStdString());
+        }
         SubaddressRow& row = m_rows[addressIndex];
         row.label = label;
         emit rowUpdated(addressIndex);
@@ -177,16 +365,15 @@ bool Subaddress::setHidden(const QString &address, bool hidden)
         if (m_hidden.contains(address)) {
             return false;
         }
-        m_hidden.append(address);
+        m_hidden.insert(address);
     }
     else {
-        if (!m_hidden.contains(address)) {
+        if (!m_hidden.remove(address)) {
             return false;
         }
-        m_hidden.removeAll(address);
     }
     
-    bool r = m_wallet->setCacheAttribute("feather.hiddenaddresses", m_hidden.join(","));
+    bool r = m_wallet->setCacheAttribute("feather.hiddenaddresses", QStringList(m_hidden.cbegin(), m_hidden.cend()).join(","));
     
     refresh();
     return r;
@@ -198,27 +385,26 @@ bool Subaddress::setPinned(const QString &address, bool pinned)
         if (m_pinned.contains(address)) {
             return false;
         }
-        m_pinned.append(address);
+        m_pinned.insert(address);
     }
     else {
-        if (!m_pinned.contains(address)) {
+        if (!m_pinned.remove(address)) {
             return false;
         }
-        m_pinned.removeAll(address);
     }
 
-    bool r = m_wallet->setCacheAttribute("feather.pinnedaddresses", m_pinned.join(","));
+    bool r = m_wallet->setCacheAttribute("feather.pinnedaddresses", QStringList(m_pinned.cbegin(), m_pinned.cend()).join(","));
 
     refresh();
     return r;
 }
 
-bool Subaddress::isHidden(const QString &address) 
+bool Subaddress::isHidden(const QString &address) const
 {
     return m_hidden.contains(address);
 }
 
-bool Subaddress::isPinned(const QString &address)
+bool Subaddress::isPinned(const QString &address) const
 {
     return m_pinned.contains(address);
 }
@@ -5,14 +5,22 @@
 #define SUBADDRESS_H
 
 #include <QObject>
+#include <QHash>
+#include <QSet>
 #include <QString>
 
+#include "rows/HexKey.h"
+#include "rows/RowDelta.h"
 #include "rows/SubaddressRow.h"
 
 namespace tools {
     class wallet2;
 }
 
+namespace cryptonote {
+    struct subaddress_index;
+}
+
 class Wallet;
 class Subaddress : public QObject
 {
@@ -20,6 +28,7 @@ class Subaddress : public QObject
 
 public:
     bool refresh();
+    //! marks subaddresses that received outputs since the last call, only new transfers are looked at
     void updateUsed(quint32 accountIndex);
     [[nodiscard]] qsizetype count() const;
 
@@ -31,14 +40,17 @@ public:
     bool setLabel(quint32 addressIndex, const QString &label);
     bool setHidden(const QString& address, bool hidden);
     bool setPinned(const QString& address, bool pinned);
-    bool isHidden(const QString& address);
-    bool isPinned(const QString& address);
+    bool isHidden(const QString& address) const;
+    bool isPinned(const QString& address) const;
 
     QString getError() const;
 
 signals:
+    // Emitted around a full reset, refresh() normally only reports the rows that differ
     void refreshStarted() const;
     void refreshFinished() const;
+    void rowsAboutToChange(const RowDelta &delta) const;
+    void rowsChanged(const RowDelta &delta) const;
     void rowUpdated(qsizetype index) const;
     void corrupted() const;
     void noUnusedSubaddresses() const;
@@ -46,7 +58,12 @@ signals:
     void endAddRow() const;
 
 private:
-    bool emplaceRow(quint32 addressIndex);
+    QString deriveAddress(const cryptonote::subaddress_index &index) const;
+    bool deriveRows(QList<SubaddressRow> &rows, quint32 accountIndex, quint32 count, bool parallel);
+    bool emplaceRow(QList<SubaddressRow> &rows, quint32 addressIndex);
+    bool scanTransfers(QSet<quint32> &used);
+    void syncUsed();
+    void countUnused();
 
     explicit Subaddress(Wallet *wallet, tools::wallet2 *wallet2, QObject *parent);
     friend class Wallet;
@@ -54,9 +71,17 @@ private:
     Wallet* m_wallet;
     tools::wallet2 *m_wallet2;
     QList<SubaddressRow> m_rows;
-    
-    QStringList m_pinned;
-    QStringList m_hidden;
+    QHash<quint32, QList<SubaddressRow>> m_accounts; // rows of accounts shown before, by account index
+    quint32 m_account = 0; // account shown in m_rows
+
+    // Subaddresses that received an output, from transfers below m_scannedTransfers
+    QHash<quint32, QSet<quint32>> m_used; // account -> subaddress indexes
+    size_t m_scannedTransfers = 0;
+    HexKey m_lastKey; // output public key of the last scanned transfer
+    qsizetype m_unused = 0; // rows of m_rows that are not used, the primary address excluded
+
+    QSet<QString> m_pinned;
+    QSet<QString> m_hidden;
 
     QString m_errorString;
 };
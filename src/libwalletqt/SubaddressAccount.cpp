@@ -2,10 +2,12 @@
 // SPDX-FileCopyrightText: The Monero Project
 
 #include "SubaddressAccount.h"
+#include "Wallet.h"
 #include <wallet/wallet2.h>
 
-SubaddressAccount::SubaddressAccount(tools::wallet2 *wallet2, QObject *parent)
+SubaddressAccount::SubaddressAccount(Wallet *wallet, tools::wallet2 *wallet2, QObject *parent)
     : QObject(parent)
+    , m_wallet(wallet)
     , m_wallet2(wallet2)
 {
 }
@@ -21,13 +23,32 @@ void SubaddressAccount::refresh()
         m_rows.emplace_back(
             QString::fromStdString(m_wallet2->get_subaddress_as_str({i,0})),
             QString::fromStdString(m_wallet2->get_subaddress_label({i,0})),
-            m_wallet2->balance(i, false),
-            m_wallet2->unlocked_balance(i, false));
+            m_wallet->balance(i),
+            m_wallet->unlockedBalance(i));
     }
 
     emit refreshFinished();
 }
 
+void SubaddressAccount::updateBalances()
+{
+    bool changed = false;
+    for (qsizetype i = 0; i < m_rows.size(); ++i) {
+        AccountRow &row = m_rows[i];
+        quint64 balance = m_wallet->balance(i);
+        quint64 unlockedBalance = m_wallet->unlockedBalance(i);
+        if (row.balance != balance || row.unlockedBalance != unlockedBalance) {
+            row.balance = balance;
+            row.unlockedBalance = unlockedBalance;
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        emit balancesChanged();
+    }
+}
+
 qsizetype SubaddressAccount::count() const
 {
     return m_rows.length();
@@ -48,12 +69,19 @@ const QList<AccountRow>& SubaddressAccount::getRows()
 
 void SubaddressAccount::addRow(const QString &label)
 {
-    m_wallet2->add_subaddress_account(label.toStdString());
+    {
+        QMutexLocker locker(m_wallet->storeMutex());
+        m_wallet2->add_subaddress_account(label.toStdString());
+    }
     refresh();
 }
 
 void SubaddressAccount::setLabel(quint32 accountIndex, const QString &label)
 {
-    m_wallet2->set_subaddress_label({accountIndex, 0}, label.toStdString());
+    {
+        QMutexLocker locker(m_wallet->storeMutex());
+        m_wallet2->set_subaddress_label({accountIndex, 0}, label.toStdString());
+    }
     refresh();
+    emit labelChanged(accountIndex);
 }
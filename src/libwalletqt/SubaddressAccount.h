@@ -13,12 +13,15 @@ namespace tools {
     class wallet2;
 }
 
+class Wallet;
 class SubaddressAccount : public QObject
 {
     Q_OBJECT
 
 public:
     void refresh();
+    //! balances only, rows stay where they are
+    void updateBalances();
     qsizetype count() const;
 
     const AccountRow& row(int index) const;
@@ -30,11 +33,14 @@ public:
 signals:
     void refreshStarted() const;
     void refreshFinished() const;
+    void balancesChanged() const;
+    void labelChanged(quint32 accountIndex) const;
 
 private:
-    explicit SubaddressAccount(tools::wallet2 *wallet2, QObject *parent);
+    explicit SubaddressAccount(Wallet *wallet, tools::wallet2 *wallet2, QObject *parent);
     friend class Wallet;
 
+    Wallet *m_wallet;
     tools::wallet2 *m_wallet2;
     QList<AccountRow> m_rows;
 };
@@ -11,6 +11,24 @@
 #include "rows/Output.h"
 #include "wallet/wallet2.h"
 
+#include <algorithm>
+#include <utility>
+
+namespace {
+    // Confirmed rows this close to the tip are re-read on every refresh to pick up short reorgs, deeper ones
+    // are reported by reorged()
+    constexpr quint64 reorgWindow = 10;
+
+    // Rows locked for longer aren't updated on every block, views pick up their confirmations on the next
+    // repaint. Timestamp unlocks count as billions of blocks and are never tracked.
+    constexpr quint64 maxTrackedLock = 720;
+
+    bool tracked(const TransactionRow &row, quint64 walletHeight)
+    {
+        return row.maturing(walletHeight) && row.confirmationsRequired() <= maxTrackedLock;
+    }
+}
+
 TransactionHistory::TransactionHistory(Wallet *wallet, tools::wallet2 *wallet2, QObject *parent)
     : QObject(parent)
     , m_wallet(wallet)
@@ -20,247 +38,611 @@ TransactionHistory::TransactionHistory(Wallet *wallet, tools::wallet2 *wallet2,
 
 }
 
-QString description(tools::wallet2 *wallet2, const tools::wallet2::payment_details &pd)
+QString defaultDescription(const TransactionRow &row)
 {
-    QString description = QString::fromStdString(wallet2->get_tx_note(pd.m_tx_hash));
-    if (description.isEmpty()) {
-        if (pd.m_coinbase) {
-            description = "Coinbase";
-        }
-        else if (pd.m_subaddr_index.major == 0 && pd.m_subaddr_index.minor == 0) {
-            description = "Primary address";
-        }
-        else {
-            description = QString::fromStdString(wallet2->get_subaddress_label(pd.m_subaddr_index));
-        }
+    // Shown for rows without a tx note
+    if (row.direction != TransactionRow::Direction_In) {
+        return {};
+    }
+    if (row.coinbase) {
+        return "Coinbase";
     }
-    return description;
+    if (row.subaddrAccount == 0 && row.subaddrIndex == QSet<quint32>{0}) {
+        return "Primary address";
+    }
+    return row.label;
+}
+
+QString searchText(const TransactionRow &row)
+{
+    // Everything the history search box matches against, except for addresses
+    return QString("%1\n%2\n%3").arg(row.txid.toHex(), row.description, row.label);
+}
+
+QByteArray rowKey(const TransactionRow &row)
+{
+    // Identifies a row across refreshes, incoming transfers get one row per receiving subaddress
+    qint64 minor = row.subaddrIndex.isEmpty() ? -1 : *std::min_element(row.subaddrIndex.begin(), row.subaddrIndex.end());
+
+    QByteArray key(reinterpret_cast<const char*>(row.txid.bytes.data()), row.txid.bytes.size());
+    key.append(char(row.direction));
+    key.append(char(row.pending));
+    key.append(reinterpret_cast<const char*>(&row.blockHeight), sizeof(row.blockHeight));
+    key.append(reinterpret_cast<const char*>(&minor), sizeof(minor));
+    return key;
 }
 
 void TransactionHistory::refresh()
 {
-    qDebug() << Q_FUNC_INFO;
+    if (!m_wanted) {
+        return;
+    }
+    this->requestRows(false);
+}
 
-    emit refreshStarted();
+void TransactionHistory::reload()
+{
+    m_wanted = true;
+    this->requestRows(true);
+}
 
-    {
-        QWriteLocker locker(&m_lock);
+void TransactionHistory::load()
+{
+    if (!m_wanted) {
+        this->reload();
+    }
+}
 
-        m_rows.clear();
+bool TransactionHistory::loaded() const
+{
+    return m_scanned;
+}
 
-        quint64 lastTxHeight = 0;
-        bool hasFakePaymentId = m_wallet->isTrezor();
-        m_locked = false;
+void TransactionHistory::reorged()
+{
+    m_reorged = true;
+
+    // A build in flight may still see the detached blocks
+    if (m_building) {
+        m_pendingRefresh = true;
+    }
+}
 
-        uint64_t min_height = 0;
-        uint64_t max_height = (uint64_t)-1;
-        uint64_t wallet_height = m_wallet->blockChainHeight();
-        uint32_t account = m_wallet->currentSubaddressAccount();
+void TransactionHistory::requestRows(bool full)
+{
+    qDebug() << Q_FUNC_INFO;
 
-        // transactions are stored in wallet2:
-        // - confirmed_transfer_details   - out transfers
-        // - unconfirmed_transfer_details - pending out transfers
-        // - payment_details              - input transfers
+    // Rows of all accounts are kept, switching accounts only swaps the visible list
+    quint32 account = m_wallet->currentSubaddressAccount();
+    if (m_scanned && account != lastAccountIndex) {
+        emit refreshStarted();
+        m_accounts[lastAccountIndex] = std::move(m_rows);
+        m_rows = m_accounts.take(account);
+        lastAccountIndex = account;
+        this->findMaturing();
+        emit refreshFinished();
+    }
 
-        // payments are "input transactions";
-        // one input transaction contains only one transfer. e.g. <transaction_id> - <100XMR>
+    // One build at a time, requests that arrive meanwhile are merged into a single follow-up
+    if (m_building) {
+        m_pendingRefresh = true;
+        m_pendingReload = m_pendingReload || full;
+        return;
+    }
 
-        std::list<std::pair<crypto::hash, tools::wallet2::payment_details>> in_payments;
-        m_wallet2->get_payments(in_payments, min_height, max_height);
-        for (std::list<std::pair<crypto::hash, tools::wallet2::payment_details>>::const_iterator i = in_payments.begin(); i != in_payments.end(); ++i)
-        {
-            const tools::wallet2::payment_details &pd = i->second;
-            if (pd.m_subaddr_index.major != account) {
-                continue;
+    quint64 walletHeight = m_wallet->blockChainHeight();
+
+    // Anything that invalidates more than the reorg window requires a rebuild
+    full = full || m_reorged || !m_scanned || walletHeight + reorgWindow < m_scannedHeight;
+    m_reorged = false;
+
+    // Otherwise, confirmed rows above the floor and all pool rows may have changed since the last pass
+    quint64 floor = (!full && m_scannedHeight > reorgWindow) ? m_scannedHeight - reorgWindow : 0;
+
+    m_building = true;
+    bool scheduled = m_wallet->runAsync([this, full, floor] {
+        // Beware! This code does not run in the GUI thread.
+        quint64 height = m_wallet->blockChainHeight();
+        QHash<quint32, QList<TransactionRow>> rows = this->fetchRows(floor);
+
+        // A rebuild replaces the search index as well, build it here rather than in the GUI thread
+        TrigramIndex<quint32> index;
+        quint32 nextId = 0;
+        if (full) {
+            for (auto &accountRows : rows) {
+                for (auto &row : accountRows) {
+                    row.id = nextId++;
+                    index.insert(row.id, searchText(row));
+                }
             }
+        }
 
-            std::string payment_id = epee::string_tools::pod_to_hex(i->first);
-            if (payment_id.substr(16).find_first_not_of('0') == std::string::npos)
-                payment_id = payment_id.substr(0,16);
-
-            TransactionRow t;
-            t.paymentId = QString::fromStdString(payment_id);
-            t.coinbase = pd.m_coinbase;
-            t.amount = pd.m_amount;
-            t.balanceDelta = pd.m_amount;
-            t.fee = pd.m_fee;
-            t.direction = TransactionRow::Direction_In;
-            t.hash = QString::fromStdString(epee::string_tools::pod_to_hex(pd.m_tx_hash));
-            t.blockHeight = pd.m_block_height;
-            t.subaddrIndex = { pd.m_subaddr_index.minor };
-            t.subaddrAccount = pd.m_subaddr_index.major;
-            t.label = QString::fromStdString(m_wallet2->get_subaddress_label(pd.m_subaddr_index));
-            t.timestamp = QDateTime::fromSecsSinceEpoch(pd.m_timestamp);
-            t.confirmations = (wallet_height > pd.m_block_height) ? wallet_height - pd.m_block_height : 0;
-            t.unlockTime = pd.m_unlock_time;
-            t.description = description(m_wallet2, pd);
-
-            m_rows.append(std::move(t));
-        }
-
-        // confirmed output transactions
-        // one output transaction may contain more than one money transfer, e.g.
-        // <transaction_id>:
-        //    transfer1: 100XMR to <address_1>
-        //    transfer2: 50XMR  to <address_2>
-        //    fee: fee charged per transaction
-        //
-
-        std::list<std::pair<crypto::hash, tools::wallet2::confirmed_transfer_details>> out_payments;
-        m_wallet2->get_payments_out(out_payments, min_height, max_height);
-
-        for (std::list<std::pair<crypto::hash, tools::wallet2::confirmed_transfer_details>>::const_iterator i = out_payments.begin();
-             i != out_payments.end(); ++i) {
-
-            const crypto::hash &hash = i->first;
-            const tools::wallet2::confirmed_transfer_details &pd = i->second;
-            if (pd.m_subaddr_account != account) {
-                continue;
+        QMetaObject::invokeMethod(this, [this, full, floor, height, rows = std::move(rows), index = std::move(index), nextId]() mutable {
+            this->applyRows(full, floor, height, std::move(rows), std::move(index), nextId);
+        }, Qt::QueuedConnection);
+    });
+
+    if (!scheduled) {
+        m_building = false;
+    }
+}
+
+void TransactionHistory::applyRows(bool full, quint64 floor, quint64 walletHeight, QHash<quint32, QList<TransactionRow>> fetched,
+                                   TrigramIndex<quint32> index, quint32 nextId)
+{
+    m_building = false;
+
+    if (full) {
+        emit refreshStarted();
+        m_searchIndex = std::move(index);
+        m_nextId = nextId;
+        m_searchDirty = true;
+        lastAccountIndex = m_wallet->currentSubaddressAccount();
+        m_rows = fetched.take(lastAccountIndex);
+        m_accounts = std::move(fetched);
+        m_locked = false;
+        m_scanned = true;
+        m_scannedHeight = walletHeight;
+        m_height = walletHeight;
+        this->findMaturing();
+        emit refreshFinished();
+    }
+    else {
+        if (this->applyDelta(m_rows, floor, fetched.take(lastAccountIndex), true)) {
+            this->findMaturing();
+        }
+
+        for (auto it = fetched.begin(); it != fetched.end(); ++it) {
+            if (!m_accounts.contains(it.key())) {
+                m_accounts.insert(it.key(), {});
             }
+        }
+        for (auto it = m_accounts.begin(); it != m_accounts.end(); ++it) {
+            this->applyDelta(it.value(), floor, fetched.take(it.key()), false);
+        }
 
-            uint64_t change = pd.m_change == (uint64_t)-1 ? 0 : pd.m_change; // change may not be known
-            uint64_t fee = pd.m_amount_in - pd.m_amount_out;
+        m_scannedHeight = walletHeight;
+        this->setHeight(walletHeight);
+    }
 
-            std::string payment_id = epee::string_tools::pod_to_hex(i->second.m_payment_id);
-            if (payment_id.substr(16).find_first_not_of('0') == std::string::npos)
-                payment_id = payment_id.substr(0,16);
+    // A full build replaced every row, an incremental one the rows above its floor, both with what
+    // they read before these edits
+    if (!m_editedNotes.isEmpty()) {
+        this->applyNotes(std::exchange(m_editedNotes, {}));
+    }
+    for (quint32 subaddressIndex : std::exchange(m_editedLabels, {})) {
+        this->refreshLabels(subaddressIndex);
+    }
 
-            TransactionRow t;
-            t.paymentId = QString::fromStdString(payment_id);
+    if (m_pendingRefresh) {
+        bool reload = m_pendingReload;
+        m_pendingRefresh = false;
+        m_pendingReload = false;
+        this->requestRows(reload);
+    }
+}
 
-            t.amount = pd.m_amount_out - change;
-            t.balanceDelta = change - pd.m_amount_in;
-            t.fee = fee;
+bool TransactionHistory::applyDelta(QList<TransactionRow> &rows, quint64 floor, QList<TransactionRow> fetched, bool visible)
+{
+    // Only changes to the visible account are announced, the others are applied silently.
+    // Returns whether rows were inserted or removed.
+    QHash<QByteArray, qsizetype> fetchedIndex;
+    for (qsizetype i = 0; i < fetched.size(); i++) {
+        fetchedIndex.insert(rowKey(fetched[i]), i);
+    }
 
-            t.direction = TransactionRow::Direction_Out;
-            t.hash = QString::fromStdString(epee::string_tools::pod_to_hex(hash));
-            t.blockHeight = pd.m_block_height;
-            t.description = QString::fromStdString(m_wallet2->get_tx_note(hash));
-            t.subaddrAccount = pd.m_subaddr_account;
-            t.label = QString::fromStdString(pd.m_subaddr_indices.size() == 1 ? m_wallet2->get_subaddress_label({pd.m_subaddr_account, *pd.m_subaddr_indices.begin()}) : "");
-            t.timestamp = QDateTime::fromSecsSinceEpoch(pd.m_timestamp);
-            t.confirmations = (wallet_height > pd.m_block_height) ? wallet_height - pd.m_block_height : 0;
+    QList<qsizetype> removed;
+    QList<qsizetype> updated;
+    QList<bool> consumed(fetched.size(), false);
+    for (qsizetype i = 0; i < rows.size(); i++) {
+        TransactionRow &row = rows[i];
+        if (!row.pending && row.blockHeight <= floor) {
+            continue;
+        }
 
-            for (uint32_t idx : t.subaddrIndex)
-            {
-                t.subaddrIndex.insert(idx);
-            }
+        auto it = fetchedIndex.constFind(rowKey(row));
+        if (it == fetchedIndex.constEnd()) {
+            removed.append(i);
+            continue;
+        }
 
-            // single output transaction might contain multiple transfers
-            for (auto const &d: pd.m_dests)
-            {
-                t.transfers.emplace_back(
-                    d.amount,
-                    QString::fromStdString(d.address(m_wallet2->nettype(), pd.m_payment_id, !hasFakePaymentId)));
-            }
-            for (auto const &r: pd.m_rings)
-            {
-                t.rings.emplace_back(
-                    QString::fromStdString(epee::string_tools::pod_to_hex(r.first)),
-                    cryptonote::relative_output_offsets_to_absolute(r.second));
-            }
+        consumed[it.value()] = true;
+        const TransactionRow &fresh = fetched[it.value()];
+        if (row.failed != fresh.failed || row.description != fresh.description || row.label != fresh.label) {
+            this->unindexRow(row);
+            row.failed = fresh.failed;
+            row.description = fresh.description;
+            row.label = fresh.label;
+            this->indexRow(row);
+            updated.append(i);
+        }
+    }
 
-            m_rows.append(std::move(t));
+    // Remove back to front so the ranges stay valid
+    for (qsizetype end = removed.size() - 1; end >= 0;) {
+        qsizetype begin = end;
+        while (begin > 0 && removed[begin - 1] == removed[begin] - 1) {
+            begin--;
         }
 
-        // unconfirmed output transactions
-        std::list<std::pair<crypto::hash, tools::wallet2::unconfirmed_transfer_details>> upayments_out;
-        m_wallet2->get_unconfirmed_payments_out(upayments_out);
-        for (std::list<std::pair<crypto::hash, tools::wallet2::unconfirmed_transfer_details>>::const_iterator i = upayments_out.begin(); i != upayments_out.end(); ++i) {
-            const tools::wallet2::unconfirmed_transfer_details &pd = i->second;
-            if (pd.m_subaddr_account != account) {
-                continue;
+        RowDelta delta{RowDelta::Removed, removed[begin], removed[end]};
+        for (qsizetype i = delta.first; i <= delta.last; i++) {
+            this->unindexRow(rows[i]);
+        }
+        if (visible) emit rowsAboutToChange(delta);
+        rows.remove(delta.first, delta.last - delta.first + 1);
+        if (visible) emit rowsChanged(delta);
+
+        // Indexes of updated rows behind the removed range shift down
+        for (auto &index : updated) {
+            if (index > delta.last) {
+                index -= delta.last - delta.first + 1;
             }
+        }
+        end = begin - 1;
+    }
 
-            const crypto::hash &hash = i->first;
-            uint64_t amount = pd.m_amount_in;
-            uint64_t fee = amount - pd.m_amount_out;
-            uint64_t change = pd.m_change == (uint64_t)-1 ? 0 : pd.m_change;
-            std::string payment_id = epee::string_tools::pod_to_hex(i->second.m_payment_id);
-            if (payment_id.substr(16).find_first_not_of('0') == std::string::npos)
-                payment_id = payment_id.substr(0,16);
-            bool is_failed = pd.m_state == tools::wallet2::unconfirmed_transfer_details::failed;
-
-            TransactionRow t;
-            t.paymentId = QString::fromStdString(payment_id);
-
-            t.amount = pd.m_amount_out - change;
-            t.balanceDelta = change - pd.m_amount_in;
-            t.fee = fee;
-
-            t.direction = TransactionRow::Direction_Out;
-            t.failed = is_failed;
-            t.pending = true;
-            t.hash = QString::fromStdString(epee::string_tools::pod_to_hex(hash));
-            t.description = QString::fromStdString(m_wallet2->get_tx_note(hash));
-            t.subaddrAccount = pd.m_subaddr_account;
-            t.label = QString::fromStdString(pd.m_subaddr_indices.size() == 1 ? m_wallet2->get_subaddress_label({pd.m_subaddr_account, *pd.m_subaddr_indices.begin()}) : "");
-            t.timestamp = QDateTime::fromSecsSinceEpoch(pd.m_timestamp);
-            t.confirmations = 0;
-            for (uint32_t idx : t.subaddrIndex)
-            {
-                t.subaddrIndex.insert(idx);
-            }
+    QList<TransactionRow> inserted;
+    for (qsizetype i = 0; i < fetched.size(); i++) {
+        if (!consumed[i]) {
+            fetched[i].id = m_nextId++;
+            this->indexRow(fetched[i]);
+            inserted.append(std::move(fetched[i]));
+        }
+    }
 
-            for (auto const &d: pd.m_dests)
-            {
-                t.transfers.emplace_back(
-                    d.amount,
-                    QString::fromStdString(d.address(m_wallet2->nettype(), pd.m_payment_id, !hasFakePaymentId)));
-            }
-            for (auto const &r: pd.m_rings)
-            {
-                t.rings.emplace_back(
-                    QString::fromStdString(epee::string_tools::pod_to_hex(r.first)),
-                    cryptonote::relative_output_offsets_to_absolute(r.second));
-            }
+    if (!inserted.isEmpty()) {
+        RowDelta delta{RowDelta::Inserted, rows.size(), rows.size() + inserted.size() - 1};
+        if (visible) emit rowsAboutToChange(delta);
+        rows.append(std::move(inserted));
+        if (visible) emit rowsChanged(delta);
+    }
+
+    std::sort(updated.begin(), updated.end());
+    updated.erase(std::unique(updated.begin(), updated.end()), updated.end());
+    if (visible) {
+        this->emitUpdated(updated);
+    }
 
-            m_rows.append(std::move(t));
+    return !removed.isEmpty() || !inserted.isEmpty();
+}
+
+void TransactionHistory::applyNotes(const QHash<HexKey, QString> &notes)
+{
+    auto apply = [this, &notes](TransactionRow &row) {
+        auto note = notes.constFind(row.txid);
+        if (note == notes.constEnd()) {
+            return false;
+        }
+        QString description = note->isEmpty() ? defaultDescription(row) : *note;
+        if (row.description == description) {
+            return false;
+        }
+        this->unindexRow(row);
+        row.description = description;
+        this->indexRow(row);
+        return true;
+    };
+
+    QList<qsizetype> updated;
+    for (qsizetype i = 0; i < m_rows.size(); i++) {
+        if (apply(m_rows[i])) {
+            updated.append(i);
+        }
+    }
+    for (auto &rows : m_accounts) {
+        for (auto &row : rows) {
+            apply(row);
         }
+    }
 
+    this->emitUpdated(updated);
+}
 
-        // unconfirmed payments (tx pool)
-        std::list<std::pair<crypto::hash, tools::wallet2::pool_payment_details>> upayments;
-        m_wallet2->get_unconfirmed_payments(upayments);
-        for (std::list<std::pair<crypto::hash, tools::wallet2::pool_payment_details>>::const_iterator i = upayments.begin(); i != upayments.end(); ++i) {
-            const tools::wallet2::payment_details &pd = i->second.m_pd;
-            if (pd.m_subaddr_index.major != account) {
-                continue;
-            }
+void TransactionHistory::emitUpdated(const QList<qsizetype> &rows)
+{
+    // rows must be sorted, consecutive rows are reported as one range
+    for (qsizetype begin = 0; begin < rows.size();) {
+        qsizetype end = begin;
+        while (end + 1 < rows.size() && rows[end + 1] == rows[end] + 1) {
+            end++;
+        }
+
+        RowDelta delta{RowDelta::Updated, rows[begin], rows[end]};
+        emit rowsAboutToChange(delta);
+        emit rowsChanged(delta);
+        begin = end + 1;
+    }
+}
+
+void TransactionHistory::setHeight(quint64 walletHeight)
+{
+    if (walletHeight == m_height) {
+        return;
+    }
+    m_height = walletHeight;
+
+    if (m_maturing.isEmpty()) {
+        return;
+    }
+
+    // Confirmations are derived from the height at read time, only maturing rows look any different.
+    // Maturing rows can be far apart, a range per run leaves the rows in between alone.
+    this->emitUpdated(m_maturing);
+
+    m_maturing.removeIf([this](qsizetype i) {
+        return !m_rows[i].maturing(m_height);
+    });
+}
+
+void TransactionHistory::findMaturing()
+{
+    m_maturing.clear();
+    for (qsizetype i = 0; i < m_rows.size(); i++) {
+        if (tracked(m_rows[i], m_height)) {
+            m_maturing.append(i);
+        }
+    }
+}
+
+QHash<quint32, QList<TransactionRow>> TransactionHistory::fetchRows(quint64 minHeight) const
+{
+    // Runs on a worker, the transfers lock keeps wallet2 from changing underneath us
+    boost::shared_lock<boost::shared_mutex> transfers_lock(m_wallet2->m_transfers_mutex);
+
+    QHash<quint32, QList<TransactionRow>> rows; // by account
+
+    // Labels are looked up once the transfers lock is released, see below
+    struct LabelRef {
+        quint32 account;
+        qsizetype row;
+        cryptonote::subaddress_index index;
+    };
+    QList<LabelRef> labels;
+
+    uint64_t min_height = minHeight;
+    uint64_t max_height = (uint64_t)-1;
+
+    // transactions are stored in wallet2:
+    // - confirmed_transfer_details   - out transfers
+    // - unconfirmed_transfer_details - pending out transfers
+    // - payment_details              - input transfers
+
+    // payments are "input transactions";
+    // one input transaction contains only one transfer. e.g. <transaction_id> - <100XMR>
+
+    std::list<std::pair<crypto::hash, tools::wallet2::payment_details>> in_payments;
+    m_wallet2->get_payments(in_payments, min_height, max_height);
+    for (std::list<std::pair<crypto::hash, tools::wallet2::payment_details>>::const_iterator i = in_payments.begin(); i != in_payments.end(); ++i)
+    {
+        const tools::wallet2::payment_details &pd = i->second;
+        std::string payment_id = epee::string_tools::pod_to_hex(i->first);
+        if (payment_id.substr(16).find_first_not_of('0') == std::string::npos)
+            payment_id = payment_id.substr(0,16);
+
+        TransactionRow t;
+        t.paymentId = QString::fromStdString(payment_id);
+        t.coinbase = pd.m_coinbase;
+        t.amount = pd.m_amount;
+        t.balanceDelta = pd.m_amount;
+        t.fee = pd.m_fee;
+        t.direction = TransactionRow::Direction_In;
+        t.txid = HexKey::fromPod(pd.m_tx_hash);
+        t.blockHeight = pd.m_block_height;
+        t.subaddrIndex = { pd.m_subaddr_index.minor };
+        t.subaddrAccount = pd.m_subaddr_index.major;
+        t.timestamp = QDateTime::fromSecsSinceEpoch(pd.m_timestamp);
+        t.unlockTime = pd.m_unlock_time;
+
+        labels.append({t.subaddrAccount, rows[t.subaddrAccount].size(), pd.m_subaddr_index});
+        rows[t.subaddrAccount].append(std::move(t));
+    }
+
+    // confirmed output transactions
+    // one output transaction may contain more than one money transfer, e.g.
+    // <transaction_id>:
+    //    transfer1: 100XMR to <address_1>
+    //    transfer2: 50XMR  to <address_2>
+    //    fee: fee charged per transaction
+    //
 
-            std::string payment_id = epee::string_tools::pod_to_hex(i->first);
-            if (payment_id.substr(16).find_first_not_of('0') == std::string::npos)
-                payment_id = payment_id.substr(0,16);
+    std::list<std::pair<crypto::hash, tools::wallet2::confirmed_transfer_details>> out_payments;
+    m_wallet2->get_payments_out(out_payments, min_height, max_height);
 
-            TransactionRow t;
+    for (std::list<std::pair<crypto::hash, tools::wallet2::confirmed_transfer_details>>::const_iterator i = out_payments.begin();
+         i != out_payments.end(); ++i) {
 
-            t.paymentId = QString::fromStdString(payment_id);
-            t.amount = pd.m_amount;
-            t.balanceDelta = pd.m_amount;
-            t.direction = TransactionRow::Direction_In;
-            t.hash = QString::fromStdString(epee::string_tools::pod_to_hex(pd.m_tx_hash));
-            t.blockHeight = pd.m_block_height;
-            t.pending = true;
-            t.subaddrIndex = { pd.m_subaddr_index.minor };
-            t.subaddrAccount = pd.m_subaddr_index.major;
-            t.label = QString::fromStdString(m_wallet2->get_subaddress_label(pd.m_subaddr_index));
-            t.timestamp = QDateTime::fromSecsSinceEpoch(pd.m_timestamp);
-            t.confirmations = 0;
-            t.description = description(m_wallet2, pd);
+        const crypto::hash &hash = i->first;
+        const tools::wallet2::confirmed_transfer_details &pd = i->second;
+        uint64_t change = pd.m_change == (uint64_t)-1 ? 0 : pd.m_change; // change may not be known
+        uint64_t fee = pd.m_amount_in - pd.m_amount_out;
 
-            m_rows.append(std::move(t));
+        std::string payment_id = epee::string_tools::pod_to_hex(i->second.m_payment_id);
+        if (payment_id.substr(16).find_first_not_of('0') == std::string::npos)
+            payment_id = payment_id.substr(0,16);
 
-            LOG_PRINT_L1(__FUNCTION__ << ": Unconfirmed payment found " << pd.m_amount);
+        TransactionRow t;
+        t.paymentId = QString::fromStdString(payment_id);
+
+        t.amount = pd.m_amount_out - change;
+        t.balanceDelta = change - pd.m_amount_in;
+        t.fee = fee;
+
+        t.direction = TransactionRow::Direction_Out;
+        t.txid = HexKey::fromPod(hash);
+        t.blockHeight = pd.m_block_height;
+        t.subaddrAccount = pd.m_subaddr_account;
+        t.timestamp = QDateTime::fromSecsSinceEpoch(pd.m_timestamp);
+
+        for (uint32_t idx : t.subaddrIndex)
+        {
+            t.subaddrIndex.insert(idx);
+        }
+
+        if (pd.m_subaddr_indices.size() == 1) {
+            labels.append({t.subaddrAccount, rows[t.subaddrAccount].size(), {pd.m_subaddr_account, *pd.m_subaddr_indices.begin()}});
+        }
+        rows[t.subaddrAccount].append(std::move(t));
+    }
+
+    // unconfirmed output transactions
+    std::list<std::pair<crypto::hash, tools::wallet2::unconfirmed_transfer_details>> upayments_out;
+    m_wallet2->get_unconfirmed_payments_out(upayments_out);
+    for (std::list<std::pair<crypto::hash, tools::wallet2::unconfirmed_transfer_details>>::const_iterator i = upayments_out.begin(); i != upayments_out.end(); ++i) {
+        const tools::wallet2::unconfirmed_transfer_details &pd = i->second;
+        const crypto::hash &hash = i->first;
+        uint64_t amount = pd.m_amount_in;
+        uint64_t fee = amount - pd.m_amount_out;
+        uint64_t change = pd.m_change == (uint64_t)-1 ? 0 : pd.m_change;
+        std::string payment_id = epee::string_tools::pod_to_hex(i->second.m_payment_id);
+        if (payment_id.substr(16).find_first_not_of('0') == std::string::npos)
+            payment_id = payment_id.substr(0,16);
+        bool is_failed = pd.m_state == tools::wallet2::unconfirmed_transfer_details::failed;
+
+        TransactionRow t;
+        t.paymentId = QString::fromStdString(payment_id);
+
+        t.amount = pd.m_amount_out - change;
+        t.balanceDelta = change - pd.m_amount_in;
+        t.fee = fee;
+
+        t.direction = TransactionRow::Direction_Out;
+        t.failed = is_failed;
+        t.pending = true;
+        t.txid = HexKey::fromPod(hash);
+        t.subaddrAccount = pd.m_subaddr_account;
+        t.timestamp = QDateTime::fromSecsSinceEpoch(pd.m_timestamp);
+        for (uint32_t idx : t.subaddrIndex)
+        {
+            t.subaddrIndex.insert(idx);
         }
+
+        if (pd.m_subaddr_indices.size() == 1) {
+            labels.append({t.subaddrAccount, rows[t.subaddrAccount].size(), {pd.m_subaddr_account, *pd.m_subaddr_indices.begin()}});
+        }
+        rows[t.subaddrAccount].append(std::move(t));
     }
 
-    emit refreshFinished();
+
+    // unconfirmed payments (tx pool)
+    std::list<std::pair<crypto::hash, tools::wallet2::pool_payment_details>> upayments;
+    m_wallet2->get_unconfirmed_payments(upayments);
+    for (std::list<std::pair<crypto::hash, tools::wallet2::pool_payment_details>>::const_iterator i = upayments.begin(); i != upayments.end(); ++i) {
+        const tools::wallet2::payment_details &pd = i->second.m_pd;
+        std::string payment_id = epee::string_tools::pod_to_hex(i->first);
+        if (payment_id.substr(16).find_first_not_of('0') == std::string::npos)
+            payment_id = payment_id.substr(0,16);
+
+        TransactionRow t;
+
+        t.paymentId = QString::fromStdString(payment_id);
+        t.amount = pd.m_amount;
+        t.balanceDelta = pd.m_amount;
+        t.direction = TransactionRow::Direction_In;
+        t.txid = HexKey::fromPod(pd.m_tx_hash);
+        t.blockHeight = pd.m_block_height;
+        t.pending = true;
+        t.subaddrIndex = { pd.m_subaddr_index.minor };
+        t.subaddrAccount = pd.m_subaddr_index.major;
+        t.timestamp = QDateTime::fromSecsSinceEpoch(pd.m_timestamp);
+
+        labels.append({t.subaddrAccount, rows[t.subaddrAccount].size(), pd.m_subaddr_index});
+        rows[t.subaddrAccount].append(std::move(t));
+
+        LOG_PRINT_L1(__FUNCTION__ << ": Unconfirmed payment found " << pd.m_amount);
+    }
+    transfers_lock.unlock();
+
+    // Labels and notes are written by the GUI thread under the store mutex, which the transfers lock doesn't
+    // cover. Take it first, the writers lock in the same order.
+    QMutexLocker storeLocker(m_wallet->storeMutex());
+    transfers_lock.lock();
+
+    for (const auto &ref : labels) {
+        rows[ref.account][ref.row].label = QString::fromStdString(m_wallet2->get_subaddress_label(ref.index));
+    }
+    for (auto &accountRows : rows) {
+        for (auto &row : accountRows) {
+            crypto::hash txid;
+            std::memcpy(txid.data, row.txid.bytes.data(), sizeof(txid.data));
+            QString note = QString::fromStdString(m_wallet2->get_tx_note(txid));
+            row.description = note.isEmpty() ? defaultDescription(row) : note;
+        }
+    }
+
+    return rows;
 }
 
-quint64 TransactionHistory::count() const
+template <typename Fn>
+bool TransactionHistory::withOutgoing(const TransactionRow &row, Fn fn) const
 {
-    QReadLocker locker(&m_lock);
+    // Destinations and rings are only needed by detail views, they are looked up by txid instead of
+    // being copied into every row. The block height narrows the search down to a single block.
+    if (row.direction != TransactionRow::Direction_Out) {
+        return false;
+    }
+
+    boost::shared_lock<boost::shared_mutex> transfers_lock(m_wallet2->m_transfers_mutex);
 
+    crypto::hash txid;
+    std::memcpy(txid.data, row.txid.bytes.data(), sizeof(txid.data));
+
+    if (row.pending) {
+        std::list<std::pair<crypto::hash, tools::wallet2::unconfirmed_transfer_details>> upayments_out;
+        m_wallet2->get_unconfirmed_payments_out(upayments_out);
+        for (const auto &payment : upayments_out) {
+            if (payment.first == txid) {
+                fn(payment.second);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::list<std::pair<crypto::hash, tools::wallet2::confirmed_transfer_details>> out_payments;
+    m_wallet2->get_payments_out(out_payments, row.blockHeight > 0 ? row.blockHeight - 1 : 0, row.blockHeight);
+    for (const auto &payment : out_payments) {
+        if (payment.first == txid) {
+            fn(payment.second);
+            return true;
+        }
+    }
+    return false;
+}
+
+QList<Output> TransactionHistory::transfers(const TransactionRow &row) const
+{
+    bool hasFakePaymentId = m_wallet->isTrezor();
+
+    QList<Output> transfers;
+    this->withOutgoing(row, [&](const auto &pd) {
+        // single output transaction might contain multiple transfers
+        for (auto const &d: pd.m_dests)
+        {
+            transfers.emplace_back(
+                d.amount,
+                QString::fromStdString(d.address(m_wallet2->nettype(), pd.m_payment_id, !hasFakePaymentId)));
+        }
+    });
+    return transfers;
+}
+
+QList<Ring> TransactionHistory::rings(const TransactionRow &row) const
+{
+    QList<Ring> rings;
+    this->withOutgoing(row, [&](const auto &pd) {
+        for (auto const &r: pd.m_rings)
+        {
+            rings.emplace_back(
+                QString::fromStdString(epee::string_tools::pod_to_hex(r.first)),
+                cryptonote::relative_output_offsets_to_absolute(r.second));
+        }
+    });
+    return rings;
+}
+
+quint64 TransactionHistory::count() const
+{
     return m_rows.length();
 }
 
@@ -277,18 +659,116 @@ const QList<TransactionRow>& TransactionHistory::getRows()
     return m_rows;
 }
 
+quint64 TransactionHistory::height() const
+{
+    return m_height;
+}
+
 void TransactionHistory::setTxNote(const QString &txid, const QString &note)
 {
-    cryptonote::blobdata txid_data;
-    if (!epee::string_tools::parse_hexstr_to_binbuff(txid.toStdString(), txid_data) || txid_data.size() != sizeof(crypto::hash)) {
+    bool ok = false;
+    HexKey key = HexKey::fromHex(txid, &ok);
+    if (!ok) {
         qDebug() << Q_FUNC_INFO << "invalid txid";
         return;
     }
 
-    const crypto::hash htxid = *reinterpret_cast<const crypto::hash*>(txid_data.data());
+    this->setTxNotes({{key, note}});
+}
+
+void TransactionHistory::setTxNotes(const QHash<HexKey, QString> &notes)
+{
+    if (notes.isEmpty()) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(m_wallet->storeMutex());
+        for (auto it = notes.cbegin(); it != notes.cend(); ++it) {
+            crypto::hash txid;
+            std::memcpy(txid.data, it.key().bytes.data(), sizeof(txid.data));
+            m_wallet2->set_tx_note(txid, it.value().toStdString());
+        }
+    }
+
+    this->applyNotes(notes);
+
+    // A build in flight read the old notes
+    if (m_building) {
+        m_editedNotes.insert(notes);
+    }
+
+    emit txNotesChanged(QSet<HexKey>(notes.keyBegin(), notes.keyEnd()));
+}
+
+void TransactionHistory::refreshLabels(quint32 subaddressIndex)
+{
+    // Outgoing rows don't track their subaddresses, those labels are picked up by reload()
+    QString label = QString::fromStdString(m_wallet2->get_subaddress_label({lastAccountIndex, subaddressIndex}));
+
+    // A build in flight read the old label
+    if (m_building) {
+        m_editedLabels.insert(subaddressIndex);
+    }
+
+    for (qsizetype i = 0; i < m_rows.size(); i++) {
+        TransactionRow &row = m_rows[i];
+        if (row.direction != TransactionRow::Direction_In || !row.subaddrIndex.contains(subaddressIndex) || row.label == label) {
+            continue;
+        }
+
+        bool hasNote = row.description != defaultDescription(row);
+        this->unindexRow(row);
+        row.label = label;
+        if (!hasNote) {
+            row.description = defaultDescription(row);
+        }
+        this->indexRow(row);
+
+        RowDelta delta{RowDelta::Updated, i, i};
+        emit rowsAboutToChange(delta);
+        emit rowsChanged(delta);
+    }
+}
+
+const QSet<quint32>* TransactionHistory::searchCandidates(const QString &text)
+{
+    if (!TrigramIndex<quint32>::isPlain(text)) {
+        return nullptr;
+    }
 
-    m_wallet2->set_tx_note(htxid, note.toStdString());
-    emit txNoteChanged();
+    // The proxy asks once per row, the lookup only runs again if the query or the index changed
+    if (m_searchDirty || text != m_searchQuery) {
+        m_searchQuery = text;
+        m_searchResult = m_searchIndex.candidates(text);
+        m_searchDirty = false;
+    }
+
+    return m_searchResult ? &*m_searchResult : nullptr;
+}
+
+qsizetype TransactionHistory::rowOf(quint32 id) const
+{
+    // Ids are handed out in ascending order and new rows are appended, every list is sorted by id
+    auto it = std::lower_bound(m_rows.cbegin(), m_rows.cend(), id, [](const TransactionRow &row, quint32 id) {
+        return row.id < id;
+    });
+    if (it == m_rows.cend() || it->id != id) {
+        return -1;
+    }
+    return it - m_rows.cbegin();
+}
+
+void TransactionHistory::indexRow(const TransactionRow &row)
+{
+    m_searchIndex.insert(row.id, searchText(row));
+    m_searchDirty = true;
+}
+
+void TransactionHistory::unindexRow(const TransactionRow &row)
+{
+    m_searchIndex.remove(row.id, searchText(row));
+    m_searchDirty = true;
 }
 
 bool TransactionHistory::locked() const
@@ -364,7 +844,7 @@ QString TransactionHistory::importLabelsFromCSV(const QString &fileName) {
     }
     qint64 maxIndex = std::max(txidField, descriptionField);
 
-    QList<QPair<QString, QString>> descriptions;
+    QHash<HexKey, QString> descriptions;
 
     for (int i = 1; i < fields.length(); i++) {
         const auto& row = fields[i];
@@ -381,14 +861,20 @@ QString TransactionHistory::importLabelsFromCSV(const QString &fileName) {
             continue;
         }
 
-        descriptions.push_back({row[txidField], row[descriptionField]});
-    }
+        bool ok = false;
+        HexKey txid = HexKey::fromHex(row[txidField], &ok);
+        if (!ok) {
+            qDebug() << "Invalid txid in CSV:" << row[txidField];
+            continue;
+        }
 
-    for (const auto& description : descriptions) {
-        qDebug() << "Setting note for tx:" << description.first << "description:" << description.second;
-        this->setTxNote(description.first, description.second);
+        descriptions.insert(txid, row[descriptionField]);
     }
 
+    // All at once, the rows and coins are patched in a single pass
+    qDebug() << "Setting notes for" << descriptions.size() << "transactions";
+    this->setTxNotes(descriptions);
+
     this->refresh();
 
     return {};
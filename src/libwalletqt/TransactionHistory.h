@@ -4,9 +4,16 @@
 #ifndef FEATHER_TRANSACTIONHISTORY_H
 #define FEATHER_TRANSACTIONHISTORY_H
 
-#include <QReadWriteLock>
+#include <QObject>
+#include <QHash>
+#include <QSet>
 
+#include <optional>
+
+#include "rows/RowDelta.h"
 #include "rows/TransactionRow.h"
+#include "rows/Output.h"
+#include "utils/TrigramIndex.h"
 
 namespace tools {
     class wallet2;
@@ -23,34 +30,79 @@ class TransactionHistory : public QObject
     Q_OBJECT
 
 public:
+    //! applies changes since the last refresh, see rowsAboutToChange/rowsChanged
+    //! rows are built on a worker thread, this returns immediately
+    //! does nothing until the rows were asked for by load() or reload()
     void refresh();
+    //! rebuilds all rows
+    void reload();
+    //! builds the rows if nothing did yet
+    void load();
+    //! whether the first build has finished
+    bool loaded() const;
+    //! wallet2 detached blocks, possibly deeper than the rows refresh() re-reads. The next refresh() rebuilds.
+    void reorged();
     quint64 count() const;
 
     const TransactionRow& transaction(int index);
     const QList<TransactionRow>& getRows();
+    //! wallet height the rows were last refreshed at, confirmations are relative to it
+    quint64 height() const;
+
+    //! destinations and rings of an outgoing transaction, read from the wallet on every call
+    QList<Output> transfers(const TransactionRow &row) const;
+    QList<Ring> rings(const TransactionRow &row) const;
 
     void setTxNote(const QString &txid, const QString &note);
+    //! one pass over the rows however many notes there are, by txid
+    void setTxNotes(const QHash<HexKey, QString> &notes);
+    void refreshLabels(quint32 subaddressIndex);
+
+    //! ids of rows whose txid, description or label may contain text, case-insensitive.
+    //! nullptr if the index can't narrow it down and every row has to be checked.
+    const QSet<quint32>* searchCandidates(const QString &text);
+    //! row of the current account with the given id, -1 if it belongs to another account or is gone
+    qsizetype rowOf(quint32 id) const;
     bool locked() const;
 
     QString importLabelsFromCSV(const QString &fileName);
 
 signals:
+    // Emitted around reload(), the rows are replaced as a whole
     void refreshStarted() const;
     void refreshFinished() const;
     void firstDateTimeChanged() const;
     void lastDateTimeChanged() const;
-    void txNoteChanged() const;
+    void txNotesChanged(const QSet<HexKey> &txids) const;
+
+    // Emitted around each change applied by refresh(), rows are not touched in between
+    void rowsAboutToChange(const RowDelta &delta) const;
+    void rowsChanged(const RowDelta &delta) const;
 
 private:
     explicit TransactionHistory(Wallet *wallet, tools::wallet2 *wallet2, QObject *parent = nullptr);
 
+    void requestRows(bool full);
+    QHash<quint32, QList<TransactionRow>> fetchRows(quint64 minHeight) const;
+    void applyRows(bool full, quint64 floor, quint64 walletHeight, QHash<quint32, QList<TransactionRow>> fetched,
+                   TrigramIndex<quint32> index, quint32 nextId);
+    bool applyDelta(QList<TransactionRow> &rows, quint64 floor, QList<TransactionRow> fetched, bool visible);
+    void applyNotes(const QHash<HexKey, QString> &notes);
+    void emitUpdated(const QList<qsizetype> &rows);
+    void setHeight(quint64 walletHeight);
+    void findMaturing();
+    void indexRow(const TransactionRow &row);
+    void unindexRow(const TransactionRow &row);
+    template <typename Fn>
+    bool withOutgoing(const TransactionRow &row, Fn fn) const;
+
 private:
     friend class Wallet;
-    mutable QReadWriteLock m_lock;
 
     Wallet *m_wallet;
     tools::wallet2 *m_wallet2;
-    QList<TransactionRow> m_rows;
+    QList<TransactionRow> m_rows; // only touched on the GUI thread, workers hand over whole lists
+    QHash<quint32, QList<TransactionRow>> m_accounts; // rows of the other accounts, by account index
 
     mutable QDateTime   m_firstDateTime;
     mutable QDateTime   m_lastDateTime;
@@ -59,6 +111,30 @@ private:
     mutable bool m_locked;
 
     quint32 lastAccountIndex = 0;
+
+    // Wallet height at the last refresh, rows below it (minus the reorg window) are final
+    bool m_scanned = false;
+    quint64 m_scannedHeight = 0;
+
+    quint64 m_height = 0;
+    QList<qsizetype> m_maturing; // visible rows whose confirmations still matter, ascending
+
+    // Rows of all accounts, by TransactionRow::id
+    TrigramIndex<quint32> m_searchIndex;
+    quint32 m_nextId = 0;
+    QString m_searchQuery;
+    std::optional<QSet<quint32>> m_searchResult;
+    bool m_searchDirty = true;
+
+    bool m_wanted = false; // rows were asked for, until then there is nothing to keep up to date
+    bool m_building = false;
+    bool m_pendingRefresh = false;
+    bool m_pendingReload = false;
+    bool m_reorged = false;
+
+    // Edits made while a build runs, it read the rows before them. Applied again once it's done.
+    QHash<HexKey, QString> m_editedNotes;
+    QSet<quint32> m_editedLabels; // subaddress indexes of the current account
 };
 
 #endif // FEATHER_TRANSACTIONHISTORY_H
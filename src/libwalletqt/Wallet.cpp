@@ -4,15 +4,22 @@
 #include "Wallet.h"
 
 #include <chrono>
-#include <thread>
+#include <fstream>
+#include <mutex>
+
+#include <QDeadlineTimer>
 
 #include "AddressBook.h"
 #include "Coins.h"
+#include "RefreshCoalescer.h"
 #include "Subaddress.h"
 #include "SubaddressAccount.h"
 #include "TransactionHistory.h"
 #include "WalletManager.h"
 #include "WalletListenerImpl.h"
+#include "WalletAutosave.h"
+#include "WalletSearch.h"
+#include "WalletSyncCoordinator.h"
 
 #include "config.h"
 #include "constants.h"
@@ -27,9 +34,32 @@
 #include "utils/ScopeGuard.h"
 
 #include "wallet/wallet2.h"
+#include "common/util.h"
+#include "serialization/binary_archive.h"
 
 namespace {
     constexpr char ATTRIBUTE_SUBADDRESS_ACCOUNT[] = "feather.subaddress_account";
+
+    // The file half of wallet2::store_to(): written next to the cache file and renamed over it,
+    // a crash never leaves half a cache behind
+    bool writeCacheFile(const std::string &path, tools::wallet2::cache_file_data &data, QString &error) {
+        const std::string newPath = path + ".new";
+        {
+            std::ofstream ostr(newPath, std::ios_base::binary | std::ios_base::out | std::ios_base::trunc);
+            binary_archive<true> oar(ostr);
+            if (!::serialization::serialize(oar, data) || !(ostr.flush() && ostr.good())) {
+                error = QString("Failed to write %1").arg(QString::fromStdString(newPath));
+                return false;
+            }
+        }
+
+        std::error_code e = tools::replace_file(newPath, path);
+        if (e) {
+            error = QString("Failed to rename %1: %2").arg(QString::fromStdString(newPath), QString::fromStdString(e.message()));
+            return false;
+        }
+        return true;
+    }
 }
 
 Wallet::Wallet(Monero::Wallet *wallet, QObject *parent)
@@ -38,42 +68,46 @@ Wallet::Wallet(Monero::Wallet *wallet, QObject *parent)
         , m_wallet2(wallet->getWallet())
         , m_history(new TransactionHistory(this, wallet->getWallet(), this))
         , m_historyModel(nullptr)
-        , m_addressBook(new AddressBook(wallet->getWallet(), this))
+        , m_addressBook(new AddressBook(this, wallet->getWallet(), this))
         , m_addressBookModel(nullptr)
         , m_daemonBlockChainHeight(0)
         , m_daemonBlockChainTargetHeight(0)
         , m_connectionStatus(Wallet::ConnectionStatus_Disconnected)
         , m_currentSubaddressAccount(0)
         , m_subaddress(new Subaddress(this, wallet->getWallet(), this))
-        , m_subaddressAccount(new SubaddressAccount(wallet->getWallet(), this))
+        , m_subaddressAccount(new SubaddressAccount(this, wallet->getWallet(), this))
         , m_refreshNow(false)
         , m_refreshEnabled(false)
         , m_scheduler(this)
+        , m_modelScheduler(this, &m_modelPool)
+        , m_refreshScheduler(this, &m_refreshPool)
         , m_useSSL(true)
         , m_coins(new Coins(this, wallet->getWallet(), this))
-        , m_storeTimer(new QTimer(this))
+        , m_modelRefresh(new RefreshCoalescer(conf()->get(Config::modelRefreshBudget).toInt(), this))
 {
     m_walletListener = new WalletListenerImpl(this);
     m_walletImpl->setListener(m_walletListener);
     m_currentSubaddressAccount = getCacheAttribute(ATTRIBUTE_SUBADDRESS_ACCOUNT).toUInt();
+    m_storePool.setMaxThreadCount(1);
+    m_modelPool.setMaxThreadCount(2); // history and coins
+    m_refreshPool.setMaxThreadCount(1);
 
-    m_addressBookModel = new AddressBookModel(this, m_addressBook);
-    m_subaddressModel = new SubaddressModel(this, m_subaddress);
-    m_subaddressAccountModel = new SubaddressAccountModel(this, m_subaddressAccount);
-    m_coinsModel = new CoinsModel(this, m_coins);
+    // Models are built on first use, see the getters below
+    m_search = new WalletSearch(this, this);
+    m_autosave = new WalletAutosave(this, this);
+    connect(m_autosave, &WalletAutosave::failing, this, &Wallet::autosaveFailed);
 
     if (this->status() == Status_Ok) {
         startRefreshThread();
-
-        // Store the wallet every 2 minutes
-        m_storeTimer->start(2 * 60 * 1000);
-        connect(m_storeTimer, &QTimer::timeout, [this](){
-            this->storeSafer();
-        });
-
         this->updateBalance();
     }
 
+    connect(m_modelRefresh, &RefreshCoalescer::refresh, this, [this]{
+        m_history->refresh();
+        m_coins->refresh();
+        this->subaddress()->updateUsed(this->currentSubaddressAccount());
+    });
+
     connect(this, &Wallet::refreshed, this, &Wallet::onRefreshed);
     connect(this, &Wallet::newBlock, this, &Wallet::onNewBlock);
     connect(this, &Wallet::updated, this, &Wallet::onUpdated);
@@ -83,6 +117,58 @@ Wallet::Wallet(Monero::Wallet *wallet, QObject *parent)
     connect(m_subaddress, &Subaddress::corrupted, [this]{
        emit keysCorrupted();
     });
+
+    connect(m_coins, &Coins::balancesChanged, [this]{
+        this->updateBalance();
+        m_subaddressAccount->updateBalances();
+    });
+
+    // Coin rows keep a copy of the tx note, only the outputs of the edited transaction change
+    connect(m_history, &TransactionHistory::txNotesChanged, m_coins, &Coins::refreshNotes);
+
+    // History and coin rows keep a copy of the subaddress label
+    connect(m_subaddress, &Subaddress::rowUpdated, [this](qsizetype index){
+        m_history->refreshLabels(index);
+        m_coins->refreshLabels(this->currentSubaddressAccount(), index);
+    });
+    // The account label is the label of its primary address
+    connect(m_subaddressAccount, &SubaddressAccount::labelChanged, this, [this](quint32 accountIndex){
+        m_coins->refreshLabels(accountIndex, 0);
+    });
+
+    // Coins only catches up on the next model refresh, until then balances come from wallet2
+    auto transfersMoved = [this]{
+        m_coins->invalidate();
+        this->updateBalance();
+    };
+    connect(this, &Wallet::moneyReceived, m_coins, transfersMoved);
+    connect(this, &Wallet::moneySpent, m_coins, transfersMoved);
+    connect(this, &Wallet::unconfirmedMoneyReceived, m_coins, transfersMoved);
+
+    // Everything that ends up in the cache file
+    connect(this, &Wallet::newBlock, m_autosave, [this]{
+        // While syncing, the store at the end of the sync covers the scan progress. Rewriting the
+        // whole cache every few minutes would stop the scan just as often.
+        if (this->isSynchronized()) {
+            m_autosave->markDirty(WalletAutosave::Blocks);
+        }
+    });
+    auto transfersChanged = [this]{
+        m_autosave->markDirty(WalletAutosave::Transfers);
+    };
+    connect(this, &Wallet::moneyReceived, m_autosave, transfersChanged);
+    connect(this, &Wallet::moneySpent, m_autosave, transfersChanged);
+    connect(this, &Wallet::unconfirmedMoneyReceived, m_autosave, transfersChanged);
+    connect(m_history, &TransactionHistory::txNotesChanged, m_autosave, [this]{
+        m_autosave->markDirty(WalletAutosave::Notes);
+    });
+    auto labelsChanged = [this]{
+        m_autosave->markDirty(WalletAutosave::Labels);
+    };
+    connect(m_subaddress, &Subaddress::rowUpdated, m_autosave, labelsChanged);
+    connect(m_subaddress, &Subaddress::endAddRow, m_autosave, labelsChanged);
+    connect(m_subaddressAccount, &SubaddressAccount::refreshFinished, m_autosave, labelsChanged);
+    connect(m_addressBook, &AddressBook::refreshFinished, m_autosave, labelsChanged);
 }
 
 // #################### Status ####################
@@ -139,11 +225,20 @@ quint64 Wallet::balance() const {
     return balance(m_currentSubaddressAccount);
 }
 
+// Balances are aggregated by Coins as transfers change. Models are not refreshed while syncing and Coins
+// lags a refresh behind every block, wallet2 is asked whenever the aggregates are behind.
+
 quint64 Wallet::balance(quint32 accountIndex) const {
+    if (m_coins->current()) {
+        return m_coins->balances().total(accountIndex);
+    }
     return m_wallet2->balance(accountIndex, false);
 }
 
 quint64 Wallet::balanceAll() const {
+    if (m_coins->current()) {
+        return m_coins->balances().totalAll();
+    }
     uint64_t result = 0;
     for (uint32_t i = 0; i < numSubaddressAccounts(); ++i)
         result += balance(i);
@@ -155,10 +250,16 @@ quint64 Wallet::unlockedBalance() const {
 }
 
 quint64 Wallet::unlockedBalance(quint32 accountIndex) const {
+    if (m_coins->current()) {
+        return m_coins->balances().unlocked(accountIndex);
+    }
     return m_wallet2->unlocked_balance(accountIndex, false);
 }
 
 quint64 Wallet::unlockedBalanceAll() const {
+    if (m_coins->current()) {
+        return m_coins->balances().unlockedAll();
+    }
     uint64_t result = 0;
     for (uint32_t i = 0; i < numSubaddressAccounts(); ++i)
         result += unlockedBalance(i);
@@ -166,17 +267,37 @@ quint64 Wallet::unlockedBalanceAll() const {
 }
 
 quint64 Wallet::viewOnlyBalance(quint32 accountIndex) const {
-    std::vector<std::string> kis;
-    for (const auto & ki : m_selectedInputs) {
-        kis.push_back(ki);
-    }
+    std::set<std::string> selected = m_coins->selection()->keyImages();
+    std::vector<std::string> kis(selected.begin(), selected.end());
     return m_walletImpl->viewOnlyBalance(accountIndex, kis);
 }
 
-void Wallet::updateBalance() {
+void Wallet::updateBalance(bool force) {
+    // Aggregated balances only move with transfers, spends and unlocks, Coins bumps the generation for those.
+    // Blocks, wallet updates and money callbacks invalidate Coins, wallet2 is asked until Coins caught up again.
+    bool aggregated = m_coins->current();
+    quint64 generation = m_coins->balances().generation();
+    bool sameAccount = m_balanceAccount == m_currentSubaddressAccount;
+    if (!force && aggregated && m_balanceAggregated && m_balanceGeneration == generation && sameAccount) {
+        return;
+    }
+
     quint64 balance = this->balance();
     quint64 spendable = this->unlockedBalance();
 
+    bool unchanged = m_balanceEmitted && sameAccount && m_balance == balance && m_spendable == spendable;
+
+    m_balanceEmitted = true;
+    m_balanceAggregated = aggregated;
+    m_balanceGeneration = generation;
+    m_balanceAccount = m_currentSubaddressAccount;
+    m_balance = balance;
+    m_spendable = spendable;
+
+    if (!force && unchanged) {
+        return;
+    }
+
     emit balanceUpdated(balance, spendable);
 }
 
@@ -298,14 +419,19 @@ void Wallet::switchSubaddressAccount(quint32 accountIndex) {
         m_subaddress->refresh();
         m_history->refresh();
         m_coins->refresh();
-        this->coinsModel()->setCurrentSubaddressAccount(m_currentSubaddressAccount);
+        if (m_coinsModel) {
+            m_coinsModel->setCurrentSubaddressAccount(m_currentSubaddressAccount);
+        }
         this->updateBalance();
-        this->setSelectedInputs({});
+        m_coins->selection()->clear();
         emit currentSubaddressAccountChanged();
     }
 }
 void Wallet::addSubaddressAccount(const QString& label) {
-    m_wallet2->add_subaddress_account(label.toStdString());
+    {
+        QMutexLocker locker(&m_storeMutex);
+        m_wallet2->add_subaddress_account(label.toStdString());
+    }
     switchSubaddressAccount(numSubaddressAccounts() - 1);
 }
 
@@ -362,6 +488,7 @@ QString Wallet::getSeedLanguage() const
 
 void Wallet::setSeedLanguage(const QString &lang)
 {
+    QMutexLocker locker(&m_storeMutex);
     m_wallet2->set_seed_language(lang.toStdString());
 }
 
@@ -418,6 +545,10 @@ void Wallet::initAsync(const QString &daemonAddress, bool trustedDaemon, quint64
         setTrustedDaemon(trustedDaemon);
 
         if (success) {
+            {
+                QMutexLocker locker(&m_refreshMutex);
+                m_daemonAddress = daemonAddress;
+            }
             qDebug() << "init async finished - starting refresh";
             startRefresh();
         }
@@ -431,65 +562,130 @@ void Wallet::initAsync(const QString &daemonAddress, bool trustedDaemon, quint64
 // #################### Synchronization (Refresh) ####################
 
 void Wallet::startRefresh() {
-    m_refreshEnabled = true;
+    QMutexLocker locker(&m_refreshMutex);
     m_refreshEnabled = true;
     m_refreshNow = true;
+    m_refreshCondition.wakeAll();
 }
 
 void Wallet::pauseRefresh() {
+    QMutexLocker locker(&m_refreshMutex);
     m_refreshEnabled = false;
 }
 
+void Wallet::requestRefresh() {
+    QMutexLocker locker(&m_refreshMutex);
+    m_refreshNow = true;
+    m_refreshCondition.wakeAll();
+}
+
+void Wallet::setBlockNotificationsActive(bool active) {
+    QMutexLocker locker(&m_refreshMutex);
+    if (m_blockNotificationsActive == active) {
+        return;
+    }
+    m_blockNotificationsActive = active;
+
+    // Falling back to polling, don't wait out the long interval
+    if (!active) {
+        m_refreshNow = true;
+        m_refreshCondition.wakeAll();
+    }
+}
+
 void Wallet::startRefreshThread()
 {
-    const auto future = m_scheduler.run([this] {
+    // Runs for the lifetime of the wallet on a thread of its own, waiting for a scan slot never holds up a
+    // thread of the global pool
+    const auto future = m_refreshScheduler.run([this] {
         // Beware! This code does not run in the GUI thread.
 
-        constexpr const std::chrono::seconds refreshInterval{10};
-        constexpr const std::chrono::milliseconds intervalResolution{100};
+        constexpr const std::chrono::seconds pollInterval{10};
+        // With block notifications we only poll as a safety net
+        constexpr const std::chrono::seconds notifiedPollInterval{60};
 
-        auto last = std::chrono::steady_clock::now();
-        while (!m_scheduler.stopping())
+        std::chrono::seconds refreshInterval = pollInterval;
+        QDeadlineTimer nextRefresh(refreshInterval);
+        QString daemonAddress;
+        while (true)
         {
-            if (m_refreshEnabled && (!isHwBacked() || isDeviceConnected()))
             {
-                const auto now = std::chrono::steady_clock::now();
-                const auto elapsed = now - last;
-                if (elapsed >= refreshInterval || m_refreshNow)
+                QMutexLocker locker(&m_refreshMutex);
+                refreshInterval = m_blockNotificationsActive ? notifiedPollInterval : pollInterval;
+
+                // Sleep until the next refresh is due or until a refresh is requested.
+                // While refresh is paused we only wake up on startRefresh() or shutdown.
+                // A store that interrupted the last pass wakes us up when it's done.
+                while (!m_refreshStopping && (m_storesRunning > 0 || !(m_refreshEnabled && (m_refreshNow || nextRefresh.hasExpired()))))
                 {
-                    m_refreshNow = false;
+                    if (m_refreshEnabled && m_storesRunning == 0) {
+                        m_refreshCondition.wait(&m_refreshMutex, nextRefresh);
+                    } else {
+                        m_refreshCondition.wait(&m_refreshMutex);
+                    }
+                }
 
-                    // get daemonHeight and targetHeight
-                    // daemonHeight and targetHeight will be 0 if call to get_info fails
-                    quint64 daemonHeight = m_walletImpl->daemonBlockChainHeight();
-                    bool success = daemonHeight > 0;
+                if (m_refreshStopping) {
+                    break;
+                }
 
-                    quint64 targetHeight = 0;
-                    if (success) {
-                        targetHeight = m_walletImpl->daemonBlockChainTargetHeight();
-                    }
-                    bool haveHeights = (daemonHeight > 0 && targetHeight > 0);
+                m_refreshNow = false;
+                daemonAddress = m_daemonAddress;
+            }
 
-                    emit heightsRefreshed(haveHeights, daemonHeight, targetHeight);
+            nextRefresh.setRemainingTime(refreshInterval);
+
+            // A disconnected device is picked up again by startRefresh() after reconnectDevice()
+            if (isHwBacked() && !isDeviceConnected()) {
+                continue;
+            }
 
-                    // Don't call refresh function if we don't have the daemon and target height
-                    // We do this to prevent to UI from getting confused about the amount of blocks that are still remaining
-                    if (haveHeights) {
-                        QMutexLocker locker(&m_asyncMutex);
+            // get daemonHeight and targetHeight, shared with the other wallets on this node
+            // daemonHeight and targetHeight will be 0 if call to get_info fails
+            auto heights = syncCoordinator()->heights(daemonAddress, [this]{
+                WalletSyncCoordinator::Heights fetched;
+                fetched.daemon = m_walletImpl->daemonBlockChainHeight();
+                if (fetched.daemon > 0) {
+                    fetched.target = m_walletImpl->daemonBlockChainTargetHeight();
+                }
+                return fetched;
+            });
+            quint64 daemonHeight = heights.daemon;
+            quint64 targetHeight = heights.target;
+            bool haveHeights = (daemonHeight > 0 && targetHeight > 0);
+
+            emit heightsRefreshed(haveHeights, daemonHeight, targetHeight);
+
+            // Don't call refresh function if we don't have the daemon and target height
+            // We do this to prevent to UI from getting confused about the amount of blocks that are still remaining
+            if (haveHeights) {
+                // New wallets start at daemonHeight, they are never far behind
+                quint64 walletHeight = m_newWallet ? targetHeight : m_wallet2->get_blockchain_current_height();
+                quint64 blocksBehind = targetHeight > walletHeight ? targetHeight - walletHeight : 0;
+
+                // Other wallets may be scanning, wait for our turn. Fails if the wallet is being closed.
+                if (!syncCoordinator()->acquire(this, blocksBehind)) {
+                    continue;
+                }
 
-                        if (m_newWallet) {
-                            // Set blockheight to daemonHeight for newly created wallets to speed up initial sync
-                            m_walletImpl->setRefreshFromBlockHeight(daemonHeight);
-                            m_newWallet = false;
-                        }
+                {
+                    QMutexLocker locker(&m_asyncMutex);
 
-                        m_walletImpl->refresh();
+                    if (m_newWallet) {
+                        // Set blockheight to daemonHeight for newly created wallets to speed up initial sync
+                        QMutexLocker storeLocker(&m_storeMutex);
+                        m_walletImpl->setRefreshFromBlockHeight(daemonHeight);
+                        m_newWallet = false;
                     }
-                    last = std::chrono::steady_clock::now();
+
+                    m_walletImpl->refresh();
                 }
+
+                syncCoordinator()->release(this);
             }
 
-            std::this_thread::sleep_for(intervalResolution);
+            // The interval is measured from the end of the previous pass
+            nextRefresh.setRemainingTime(refreshInterval);
         }
     });
     if (!future.first)
@@ -498,6 +694,16 @@ void Wallet::startRefreshThread()
     }
 }
 
+void Wallet::stopRefreshThread() {
+    QMutexLocker locker(&m_refreshMutex);
+    m_refreshStopping = true;
+    m_refreshEnabled = false;
+    m_refreshCondition.wakeAll();
+
+    // The refresh thread may be waiting for a scan slot
+    syncCoordinator()->cancel(this);
+}
+
 void Wallet::onHeightsRefreshed(bool success, quint64 daemonHeight, quint64 targetHeight) {
     m_daemonBlockChainHeight = daemonHeight;
     m_daemonBlockChainTargetHeight = targetHeight;
@@ -548,6 +754,16 @@ void Wallet::onNewBlock(uint64_t walletHeight) {
     // Called whenever a new block gets scanned by the wallet
     quint64 daemonHeight = m_daemonBlockChainTargetHeight;
 
+    // Outputs unlock with the height
+    m_coins->invalidate();
+
+    // Blocks are reported in order, going back means wallet2 detached blocks and scans the other chain
+    if (walletHeight <= m_lastNewBlock) {
+        m_coins->markDirty();
+        m_history->reorged();
+    }
+    m_lastNewBlock = walletHeight;
+
     if (walletHeight < (daemonHeight - 1)) {
         setConnectionStatus(ConnectionStatus_Synchronizing);
     } else {
@@ -557,22 +773,27 @@ void Wallet::onNewBlock(uint64_t walletHeight) {
     this->syncStatusUpdated(walletHeight, daemonHeight);
 
     if (this->isSynchronized()) {
-        m_history->refresh();
-        m_coins->refresh();
-        this->subaddress()->updateUsed(this->currentSubaddressAccount());
+        this->scheduleModelRefresh();
     }
 }
 
 void Wallet::onUpdated() {
+    m_coins->invalidate();
     this->updateBalance();
     if (this->isSynchronized()) {
-        m_history->refresh();
-        m_coins->refresh();
-        this->subaddress()->updateUsed(this->currentSubaddressAccount());
+        this->scheduleModelRefresh();
     }
 }
 
-void Wallet::onRefreshed(bool success, const QString &message) {
+void Wallet::scheduleModelRefresh() {
+    m_modelRefresh->schedule();
+}
+
+void Wallet::flushModelRefresh() {
+    m_modelRefresh->flush();
+}
+
+void Wallet::onRefreshed(bool success, bool interrupted, const QString &message) {
     if (!success) {
         setConnectionStatus(ConnectionStatus_Disconnected);
         // Something went wrong during refresh, in some cases we need to notify the user
@@ -580,17 +801,32 @@ void Wallet::onRefreshed(bool success, const QString &message) {
         return;
     }
 
-    if (!this->refreshedOnce) {
+    // Blocks scanned while syncing left Coins behind, catch up now that we're at the tip
+    if (!m_coins->current() && this->isSynchronized()) {
+        this->scheduleModelRefresh();
+    }
+    this->updateBalance();
+
+    // Warm up the fee estimate for coin selection
+    if (this->isSynchronized()) {
+        this->cachedBaseFee();
+    }
+
+    // The refresh pass is done, don't wait out the budget
+    this->flushModelRefresh();
+
+    // A pass a store cut short isn't the end of the sync, neither is one that didn't reach the target
+    if (!this->refreshedOnce && !interrupted && this->isSynchronized()) {
         this->refreshedOnce = true;
         emit walletRefreshed();
         // store wallet immediately upon finishing synchronization
-        this->storeSafer();
+        this->store();
     }
 }
 
 void Wallet::refreshModels() {
-    m_history->refresh();
-    m_coins->refresh();
+    m_history->reload();
+    m_coins->reload();
     m_subaddress->refresh();
 }
 
@@ -666,13 +902,23 @@ bool Wallet::exportKeyImagesForOutputsFromStr(const std::string &outputs, std::s
 }
 
 bool Wallet::importKeyImages(const QString& path) {
-    bool r = m_walletImpl->importKeyImages(path.toStdString());
+    bool r;
+    {
+        QMutexLocker locker(&m_storeMutex);
+        r = m_walletImpl->importKeyImages(path.toStdString());
+    }
+    this->coins()->markDirty();
     this->coins()->refresh();
     return r;
 }
 
 bool Wallet::importKeyImagesFromStr(const std::string &keyImages) {
-    bool r = m_walletImpl->importKeyImagesFromStr(keyImages);
+    bool r;
+    {
+        QMutexLocker locker(&m_storeMutex);
+        r = m_walletImpl->importKeyImagesFromStr(keyImages);
+    }
+    this->coins()->markDirty();
     this->coins()->refresh();
     return r;
 }
@@ -686,32 +932,111 @@ bool Wallet::exportOutputsToStr(std::string& outputs, bool all) {
 }
 
 bool Wallet::importOutputs(const QString& path) {
-    return m_walletImpl->importOutputs(path.toStdString());
+    bool r;
+    {
+        QMutexLocker locker(&m_storeMutex);
+        r = m_walletImpl->importOutputs(path.toStdString());
+    }
+    m_coins->markDirty();
+    return r;
 }
 
 bool Wallet::importOutputsFromStr(const std::string &outputs) {
-    return m_walletImpl->importOutputsFromStr(outputs);
+    bool r;
+    {
+        QMutexLocker locker(&m_storeMutex);
+        r = m_walletImpl->importOutputsFromStr(outputs);
+    }
+    m_coins->markDirty();
+    return r;
 }
 
 bool Wallet::importTransaction(const QString& txid) {
     std::vector<std::string> txids = {txid.toStdString()};
-    return m_walletImpl->scanTransactions(txids);
+    bool r;
+    {
+        QMutexLocker locker(&m_storeMutex);
+        r = m_walletImpl->scanTransactions(txids);
+    }
+    m_coins->markDirty();
+    return r;
 }
 
 // #################### Wallet cache ####################
 
 void Wallet::store() {
-    m_walletImpl->store();
-}
-
-void Wallet::storeSafer() {
-    // Do not store a synchronizing wallet: store() is NOT thread safe and may crash the wallet
-    if (!this->isSynchronized()) {
+    // Requests made before the queued store starts are served by it
+    if (m_storeQueued.exchange(true)) {
         return;
     }
 
+    QtConcurrent::run(&m_storePool, [this]{
+        // Beware! This code does not run in the GUI thread.
+        m_storeQueued = false;
+        this->storeNow();
+    });
+}
+
+bool Wallet::storeNow() {
+    // The cache is serialized and encrypted in memory under the locks, that snapshot is written
+    // without them. Cache writers on the GUI thread (notes, labels, attributes) only wait for the
+    // snapshot, never for the disk.
     qDebug() << "Storing wallet";
-    this->store();
+    {
+        QMutexLocker locker(&m_refreshMutex);
+        m_storesRunning++;
+    }
+
+    // The cache must not change under us. A refresh pass can take hours while syncing, stop it at
+    // the next batch of blocks instead of waiting for it. The refresh thread doesn't start another
+    // pass until we're done, it continues where the interrupted one left off.
+    std::unique_lock<QMutex> asyncLock(m_asyncMutex, std::defer_lock);
+    bool interrupted = false;
+    while (!asyncLock.try_lock_for(std::chrono::milliseconds(100))) {
+        // onRefreshed() must not take the pass we cut short for a finished sync
+        m_refreshInterrupted = true;
+        m_walletImpl->stop();
+        interrupted = true;
+    }
+    QMutexLocker storeLocker(&m_storeMutex);
+
+    boost::optional<tools::wallet2::cache_file_data> snapshot;
+    QString error;
+    try {
+        snapshot = m_wallet2->get_cache_file_data();
+    }
+    catch (const std::exception &e) {
+        error = e.what();
+    }
+
+    storeLocker.unlock();
+    asyncLock.unlock();
+
+    bool success = false;
+    if (snapshot) {
+        success = writeCacheFile(m_wallet2->get_wallet_file(), *snapshot, error);
+    } else if (error.isEmpty()) {
+        error = "Failed to generate wallet cache data";
+    }
+
+    {
+        QMutexLocker locker(&m_refreshMutex);
+        m_storesRunning--;
+        if (interrupted) {
+            m_refreshNow = true;
+        }
+        m_refreshCondition.wakeAll();
+    }
+
+    if (!success) {
+        qWarning() << "Error storing wallet cache:" << error;
+    }
+    emit stored(success, error);
+    return success;
+}
+
+QMutex* Wallet::storeMutex() {
+    return &m_storeMutex;
 }
 
 QString Wallet::cachePath() const {
@@ -736,7 +1061,9 @@ bool Wallet::cacheAttributeExists(const QString &key) {
 }
 
 bool Wallet::setCacheAttribute(const QString &key, const QString &val) {
+    QMutexLocker locker(&m_storeMutex);
     m_wallet2->set_attribute(key.toStdString(), val.toStdString());
+    m_autosave->markDirty(WalletAutosave::Attributes);
     return true;
 }
 
@@ -760,7 +1087,9 @@ bool Wallet::setUserNote(const QString &txid, const QString &note) {
         return false;
     const crypto::hash htxid = *reinterpret_cast<const crypto::hash*>(txid_data.data());
 
+    QMutexLocker locker(&m_storeMutex);
     m_wallet2->set_tx_note(htxid, note.toStdString());
+    m_autosave->markDirty(WalletAutosave::Notes);
     return true;
 }
 
@@ -845,14 +1174,6 @@ QString Wallet::printScannedPoolTxs() {
 
 // Phase 0: Pre-construction setup
 
-void Wallet::setSelectedInputs(const QStringList &selectedInputs) {
-    m_selectedInputs.clear();
-    for (const auto &input : selectedInputs) {
-        m_selectedInputs.insert(input.toStdString());
-    }
-    emit selectedInputsChanged(selectedInputs);
-}
-
 void Wallet::preTransactionChecks(int feeLevel) {
     pauseRefresh();
     emit initiateTransaction();
@@ -892,12 +1213,13 @@ void Wallet::createTransaction(const QString &address, quint64 amount, const QSt
     this->tmpTxDescription = description;
 
     qInfo() << "Creating transaction";
-    m_scheduler.run([this, all, address, amount, feeLevel, subtractFeeFromAmount] {
+    std::set<std::string> selectedInputs = m_coins->selection()->keyImages();
+    m_scheduler.run([this, all, address, amount, feeLevel, subtractFeeFromAmount, selectedInputs] {
         std::set<uint32_t> subaddr_indices;
 
         Monero::PendingTransaction *ptImpl = m_walletImpl->createTransaction(address.toStdString(), "", all ? std::optional<uint64_t>() : std::optional<uint64_t>(amount), constants::mixin,
                                                                              static_cast<Monero::PendingTransaction::Priority>(feeLevel),
-                                                                             currentSubaddressAccount(), subaddr_indices, m_selectedInputs, subtractFeeFromAmount);
+                                                                             currentSubaddressAccount(), subaddr_indices, selectedInputs, subtractFeeFromAmount);
 
         QVector<QString> addresses{address};
         this->onTransactionCreated(ptImpl, addresses);
@@ -908,7 +1230,8 @@ void Wallet::createTransactionMultiDest(const QVector<QString> &addresses, const
     this->tmpTxDescription = description;
 
     qInfo() << "Creating transaction";
-    m_scheduler.run([this, addresses, amounts, feeLevel, subtractFeeFromAmount] {
+    std::set<std::string> selectedInputs = m_coins->selection()->keyImages();
+    m_scheduler.run([this, addresses, amounts, feeLevel, subtractFeeFromAmount, selectedInputs] {
         std::vector<std::string> dests;
         for (auto &addr : addresses) {
             dests.push_back(addr.toStdString());
@@ -922,7 +1245,7 @@ void Wallet::createTransactionMultiDest(const QVector<QString> &addresses, const
         std::set<uint32_t> subaddr_indices;
         Monero::PendingTransaction *ptImpl = m_walletImpl->createTransactionMultDest(dests, "", amount, constants::mixin,
                                                                                      static_cast<Monero::PendingTransaction::Priority>(feeLevel),
-                                                                                     currentSubaddressAccount(), subaddr_indices, m_selectedInputs, subtractFeeFromAmount);
+                                                                                     currentSubaddressAccount(), subaddr_indices, selectedInputs, subtractFeeFromAmount);
 
         this->onTransactionCreated(ptImpl, addresses);
     });
@@ -967,7 +1290,7 @@ void Wallet::commitTransaction(PendingTransaction *tx, const QString &descriptio
     emit beginCommitTransaction();
 
     // Clear list of selected transfers
-    this->setSelectedInputs({});
+    m_coins->selection()->clear();
 
     QMap<QString, QString> txHexMap;
     for (int i = 0; i < tx->txCount(); i++) {
@@ -976,7 +1299,12 @@ void Wallet::commitTransaction(PendingTransaction *tx, const QString &descriptio
 
     m_scheduler.run([this, tx, description, txHexMap] {
         auto txIdList = tx->txid();  // retrieve before commit
-        bool success = tx->commit();
+        bool success;
+        {
+            // Commit adds the transaction and its keys to the cache
+            QMutexLocker locker(&m_storeMutex);
+            success = tx->commit();
+        }
 
         if (success && !description.isEmpty()) {
             for (const auto &txid : txIdList) {
@@ -989,8 +1317,14 @@ void Wallet::commitTransaction(PendingTransaction *tx, const QString &descriptio
 }
 
 void Wallet::onTransactionCommitted(bool success, PendingTransaction *tx, const QStringList &txid, const QMap<QString, QString> &txHexMap) {
-    // Store wallet immediately, so we don't risk losing tx key if wallet crashes
-    this->storeSafer();
+    // Store wallet soon, so we don't risk losing tx key if wallet crashes.
+    // A run of commits is coalesced into one store.
+    if (success) {
+        m_autosave->markDirty(WalletAutosave::Commit);
+    }
+
+    // Pick up the new pool transaction without waiting for the next refresh interval
+    this->requestRefresh();
 
     this->history()->refresh();
     this->coins()->refresh();
@@ -1065,9 +1399,11 @@ PendingTransaction * Wallet::loadSignedTxFromStr(const std::string &data)
 bool Wallet::submitTxFile(const QString &fileName) const
 {
     qDebug() << "Trying to submit " << fileName;
+    QMutexLocker locker(&m_storeMutex);
     if (!m_walletImpl->submitTransaction(fileName.toStdString()))
         return false;
     // import key images
+    m_coins->markDirty();
     return m_walletImpl->importKeyImages(fileName.toStdString() + "_keyImages");
 }
 
@@ -1079,7 +1415,11 @@ bool Wallet::removeFailedTx(const QString &txid)
         return false;
     }
 
-    bool r = m_wallet2->remove_failed_tx(txid_);
+    bool r;
+    {
+        QMutexLocker locker(&m_storeMutex);
+        r = m_wallet2->remove_failed_tx(txid_);
+    }
     m_history->refresh();
 
     return r;
@@ -1087,6 +1427,10 @@ bool Wallet::removeFailedTx(const QString &txid)
 
 // #################### Models ####################
 
+bool Wallet::runAsync(const std::function<void()> &job) {
+    return m_modelScheduler.run(job).first;
+}
+
 TransactionHistory *Wallet::history() const {
     return m_history;
 }
@@ -1101,6 +1445,9 @@ TransactionHistoryProxyModel *Wallet::historyModel()
         m_historySortFilterModel->setSourceModel(m_historyModel);
         m_historySortFilterModel->setSortRole(TransactionHistoryModel::Date);
         m_historySortFilterModel->sort(0, Qt::DescendingOrder);
+
+        // Rows aren't built until the first view needs them
+        m_history->load();
     }
 
     return m_historySortFilterModel;
@@ -1114,7 +1461,10 @@ AddressBook* Wallet::addressBook() const {
     return m_addressBook;
 }
 
-AddressBookModel* Wallet::addressBookModel() const {
+AddressBookModel* Wallet::addressBookModel() {
+    if (!m_addressBookModel) {
+        m_addressBookModel = new AddressBookModel(this, m_addressBook);
+    }
     return m_addressBookModel;
 }
 
@@ -1122,7 +1472,10 @@ Subaddress* Wallet::subaddress() const {
     return m_subaddress;
 }
 
-SubaddressModel* Wallet::subaddressModel() const {
+SubaddressModel* Wallet::subaddressModel() {
+    if (!m_subaddressModel) {
+        m_subaddressModel = new SubaddressModel(this, m_subaddress);
+    }
     return m_subaddressModel;
 }
 
@@ -1130,7 +1483,10 @@ SubaddressAccount* Wallet::subaddressAccount() const {
     return m_subaddressAccount;
 }
 
-SubaddressAccountModel* Wallet::subaddressAccountModel() const {
+SubaddressAccountModel* Wallet::subaddressAccountModel() {
+    if (!m_subaddressAccountModel) {
+        m_subaddressAccountModel = new SubaddressAccountModel(this, m_subaddressAccount);
+    }
     return m_subaddressAccountModel;
 }
 
@@ -1138,10 +1494,18 @@ Coins* Wallet::coins() const {
     return m_coins;
 }
 
-CoinsModel* Wallet::coinsModel() const {
+CoinsModel* Wallet::coinsModel() {
+    if (!m_coinsModel) {
+        m_coinsModel = new CoinsModel(this, m_coins);
+        m_coinsModel->setCurrentSubaddressAccount(m_currentSubaddressAccount);
+    }
     return m_coinsModel;
 }
 
+WalletSearch* Wallet::search() const {
+    return m_search;
+}
+
 // #################### Transaction proofs ####################
 
 QString Wallet::getTxKey(const QString &txid) const {
@@ -1355,6 +1719,7 @@ quint64 Wallet::getWalletCreationHeight() const {
 }
 
 void Wallet::setWalletCreationHeight(quint64 height) {
+    QMutexLocker locker(&m_storeMutex);
     m_wallet2->set_refresh_from_block_height(height);
 }
 
@@ -1368,8 +1733,10 @@ bool Wallet::createViewOnly(const QString &path, const QString &password) const
 
 bool Wallet::rescanSpent() {
     QMutexLocker locker(&m_asyncMutex);
+    QMutexLocker storeLocker(&m_storeMutex);
 
     bool r = m_walletImpl->rescanSpent();
+    m_coins->markDirty();
     m_coins->refresh();
     return r;
 }
@@ -1396,6 +1763,21 @@ bool Wallet::getBaseFees(QVector<quint64> &baseFees) {
     return true;
 }
 
+quint64 Wallet::cachedBaseFee() {
+    // get_base_fees() is a daemon RPC, it may take a while over Tor or wait for the refresh thread
+    if (this->isConnected() && m_baseFeeFresh.hasExpired() && !m_baseFeeFetching.exchange(true)) {
+        m_baseFeeFresh.setRemainingTime(std::chrono::minutes(10));
+        m_scheduler.run([this] {
+            QVector<quint64> baseFees;
+            if (this->getBaseFees(baseFees) && !baseFees.isEmpty()) {
+                m_baseFee = baseFees.first();
+            }
+            m_baseFeeFetching = false;
+        });
+    }
+    return m_baseFee;
+}
+
 bool Wallet::estimateBacklog(const QVector<quint64> &baseFees, QVector<quint64> &backlog) {
     std::vector<std::pair<double, double>> fee_levels;
 
@@ -1456,10 +1838,14 @@ Wallet::~Wallet()
 {
     qDebug() << "~Wallet: Closing wallet" << QThread::currentThreadId();
 
-    pauseRefresh();
+    stopRefreshThread();
     m_walletImpl->stop();
 
+    m_refreshScheduler.shutdownWaitForFinished();
     m_scheduler.shutdownWaitForFinished();
+    m_modelScheduler.shutdownWaitForFinished();
+    m_storePool.waitForDone();
+    syncCoordinator()->remove(this);
 
     if (status() == Status_Critical || status() == Status_BadPassword) {
         qDebug("Not storing wallet cache");
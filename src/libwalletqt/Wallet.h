@@ -5,7 +5,10 @@
 #define FEATHER_WALLET_H
 
 #include <QObject>
+#include <QDeadlineTimer>
 #include <QMutex>
+#include <QThreadPool>
+#include <QWaitCondition>
 
 #include "utils/scheduler.h"
 #include "PendingTransaction.h"
@@ -14,6 +17,7 @@
 #include "PassphraseHelper.h"
 #include "rows/TxBacklogEntry.h"
 
+#include <atomic>
 #include <set>
 
 class WalletListenerImpl;
@@ -76,6 +80,9 @@ class SubaddressAccount;
 class SubaddressAccountModel;
 class Coins;
 class CoinsModel;
+class RefreshCoalescer;
+class WalletAutosave;
+class WalletSearch;
 
 struct TxProofResult {
     TxProofResult() {}
@@ -156,7 +163,8 @@ public:
     
     quint64 viewOnlyBalance(quint32 accountIndex) const;
 
-    void updateBalance();
+    //! emits balanceUpdated if any balance changed since the last call, or always if force is set
+    void updateBalance(bool force = false);
 
     // ##### Subaddresses and Accounts #####
     QString address(quint32 accountIndex, quint32 addressIndex) const;
@@ -218,6 +226,12 @@ public:
     void startRefresh();
     void pauseRefresh();
 
+    //! wakes the refresh thread to start a refresh pass immediately (if refresh is enabled)
+    void requestRefresh();
+
+    //! while the node pushes block notifications the refresh thread polls less often
+    void setBlockNotificationsActive(bool active);
+
     //! returns current wallet's block height
     //! (can be less than daemon's blockchain height when wallet sync in progress)
     quint64 blockChainHeight() const;
@@ -270,10 +284,13 @@ public:
     bool importTransaction(const QString& txid);
 
     // ##### Wallet cache #####
-    //! saves wallet to the file by given path
-    //! empty path stores in current location
+    //! saves the wallet cache on a thread of its own, emits stored() when done
+    //! requests made while a store is queued are served by it
     void store();
-    void storeSafer();
+    //! saves the wallet cache before returning, emits stored() too
+    bool storeNow();
+    //! held by everything that writes wallet2 state kept in the cache, stores hold it while serializing
+    QMutex* storeMutex();
 
     //! returns wallet cache file path
     QString cachePath() const;
@@ -317,7 +334,6 @@ public:
     QString printScannedPoolTxs();
 
     // ##### Transactions #####
-    void setSelectedInputs(const QStringList &selected);
     void preTransactionChecks(int feeLevel);
     void automaticFeeAdjustment(int feeLevel);
     void confirmPreTransactionChecks(int feeLevel);
@@ -356,17 +372,22 @@ public:
     bool removeFailedTx(const QString &txid);
 
     // ##### Models #####
+    // Models are built the first time they are asked for
     TransactionHistory* history() const;
     TransactionHistoryProxyModel* historyModel();
     TransactionHistoryModel* transactionHistoryModel() const;
     AddressBook* addressBook() const;
-    AddressBookModel* addressBookModel() const;
+    AddressBookModel* addressBookModel();
     Subaddress* subaddress() const;
-    SubaddressModel* subaddressModel() const;
+    SubaddressModel* subaddressModel();
     SubaddressAccount* subaddressAccount() const;
-    SubaddressAccountModel* subaddressAccountModel() const;
+    SubaddressAccountModel* subaddressAccountModel();
     Coins* coins() const;
-    CoinsModel* coinsModel() const;
+    CoinsModel* coinsModel();
+    WalletSearch* search() const;
+
+    //! runs job on a pool of the wallet's own, the wallet waits for it on close
+    bool runAsync(const std::function<void()> &job);
 
     // ##### Transaction proofs #####
 
@@ -422,6 +443,8 @@ public:
 
     void getTxPoolStatsAsync();
     bool getBaseFees(QVector<quint64> &baseFees);
+    //! lowest base fee per byte the node quoted last, 0 if unknown. Never blocks, a stale value is fetched again in the background.
+    quint64 cachedBaseFee();
     bool estimateBacklog(const QVector<quint64> &baseFees, QVector<quint64> &backlog);
     bool getBlockWeightLimit(quint64 &blockWeightLimit);
 
@@ -432,7 +455,8 @@ signals:
 
     // emitted when refresh process finished (could take a long time)
     // signalling only after we
-    void refreshed(bool success, const QString &message);
+    //! interrupted if a store stopped the pass before it reached the target
+    void refreshed(bool success, bool interrupted, const QString &message);
 
     void moneySpent(const QString &txId, quint64 amount);
     void moneyReceived(const QString &txId, quint64 amount, bool coinbase);
@@ -467,10 +491,10 @@ signals:
 
     void initiateTransaction();
 
-    void selectedInputsChanged(const QStringList &selectedInputs);
-
     void multiBroadcast(const QMap<QString, QString> &txHexMap);
     void heightsRefreshed(bool success, quint64 daemonHeight, quint64 targetHeight);
+    void stored(bool success, const QString &error);
+    void autosaveFailed(const QString &error);
 
 private:
     // ###### Status ######
@@ -478,9 +502,14 @@ private:
 
     // ##### Synchronization (Refresh) #####
     void startRefreshThread();
+    void stopRefreshThread();
     void onNewBlock(uint64_t height);
     void onUpdated();
-    void onRefreshed(bool success, const QString &message);
+    void onRefreshed(bool success, bool interrupted, const QString &message);
+
+    // Block and update notifications arrive in bursts, models are refreshed at most once per budget
+    void scheduleModelRefresh();
+    void flushModelRefresh();
 
     // ##### Transactions #####
     void onTransactionCreated(Monero::PendingTransaction *mtx, const QVector<QString> &address);
@@ -494,10 +523,10 @@ private:
 
     TransactionHistory *m_history;
     TransactionHistoryModel *m_historyModel;
-    TransactionHistoryProxyModel *m_historySortFilterModel;
+    TransactionHistoryProxyModel *m_historySortFilterModel = nullptr;
 
     AddressBook *m_addressBook;
-    AddressBookModel *m_addressBookModel;
+    AddressBookModel *m_addressBookModel = nullptr;
 
     quint64 m_daemonBlockChainHeight;
     quint64 m_daemonBlockChainTargetHeight;
@@ -506,29 +535,63 @@ private:
 
     uint32_t m_currentSubaddressAccount;
     Subaddress *m_subaddress;
-    SubaddressModel *m_subaddressModel;
+    SubaddressModel *m_subaddressModel = nullptr;
     SubaddressAccount *m_subaddressAccount;
-    SubaddressAccountModel *m_subaddressAccountModel;
+    SubaddressAccountModel *m_subaddressAccountModel = nullptr;
 
     Coins *m_coins;
-    CoinsModel *m_coinsModel;
+    CoinsModel *m_coinsModel = nullptr;
+
+    WalletSearch *m_search;
+    WalletAutosave *m_autosave;
 
     QMutex m_asyncMutex;
     QString m_daemonUsername;
     QString m_daemonPassword;
 
     QMutex m_proxyMutex;
-    std::atomic<bool> m_refreshNow;
-    std::atomic<bool> m_refreshEnabled;
+
+    // Guards the refresh flags below, the refresh thread sleeps on m_refreshCondition
+    QMutex m_refreshMutex;
+    QWaitCondition m_refreshCondition;
+    bool m_refreshNow;
+    bool m_refreshEnabled;
+    bool m_refreshStopping = false;
+    bool m_blockNotificationsActive = false;
+    int m_storesRunning = 0; // no refresh pass is started while a store waits or runs
+    std::atomic<bool> m_refreshInterrupted{false}; // a store stopped the running pass, see refreshed()
+    QString m_daemonAddress; // node the wallet was initialized with, wallets on the same node share height queries
+
+    // Held while the cache is serialized, guards wallet2 writes made outside the refresh thread
+    mutable QMutex m_storeMutex;
+    QThreadPool m_storePool; // a single thread, stores never wait behind other async work
+    std::atomic<bool> m_storeQueued{false};
+
+    std::atomic<quint64> m_baseFee{0};
+    std::atomic<bool> m_baseFeeFetching{false};
+    QDeadlineTimer m_baseFeeFresh; // GUI thread only
+
     WalletListenerImpl *m_walletListener;
     FutureScheduler m_scheduler;
+    QThreadPool m_modelPool; // model rebuilds, kept off the global pool that transactions are created on
+    FutureScheduler m_modelScheduler;
+    QThreadPool m_refreshPool; // the refresh loop, it may wait for a scan slot for as long as other wallets scan
+    FutureScheduler m_refreshScheduler;
 
     bool m_useSSL;
     bool m_newWallet = false;
     bool m_forceKeyImageSync = false;
+    quint64 m_lastNewBlock = 0; // height of the last newBlock, a lower one is a reorg
+
+    RefreshCoalescer *m_modelRefresh = nullptr;
 
-    QTimer *m_storeTimer = nullptr;
-    std::set<std::string> m_selectedInputs;
+    // State of the last balanceUpdated, see updateBalance()
+    bool m_balanceEmitted = false;
+    bool m_balanceAggregated = false; // m_balanceGeneration is only meaningful if set
+    quint64 m_balanceGeneration = 0;
+    quint32 m_balanceAccount = 0;
+    quint64 m_balance = 0;
+    quint64 m_spendable = 0;
 };
 
 #endif // FEATHER_WALLET_H
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include "WalletAutosave.h"
+
+#include <algorithm>
+
+#include "Wallet.h"
+
+WalletAutosave::WalletAutosave(Wallet *wallet, QObject *parent)
+        : QObject(parent)
+        , m_wallet(wallet)
+        , m_timer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &WalletAutosave::store);
+
+    // Stores made for other reasons count against the budget too
+    connect(m_wallet, &Wallet::stored, this, &WalletAutosave::onStored);
+}
+
+std::chrono::seconds WalletAutosave::latency(Change change) {
+    switch (change) {
+        case Commit:
+            return std::chrono::seconds{5};
+        case Transfers:
+        case Notes:
+        case Labels:
+        case Attributes:
+            return std::chrono::seconds{30};
+        case Blocks:
+        default:
+            return std::chrono::seconds{120};
+    }
+}
+
+void WalletAutosave::markDirty(Change change) {
+    QMetaObject::invokeMethod(this, [this, change]{
+        m_dirty |= 1u << change;
+
+        QDeadlineTimer due(latency(change));
+        if (due < m_due) {
+            m_due = due;
+        }
+        this->schedule();
+    });
+}
+
+void WalletAutosave::schedule() {
+    if (m_dirty == 0) {
+        m_timer->stop();
+        return;
+    }
+
+    QDeadlineTimer at = m_due < m_nextAllowed ? m_nextAllowed : m_due;
+    m_timer->start(std::max<qint64>(0, at.remainingTime()));
+}
+
+void WalletAutosave::store() {
+    if (m_dirty == 0) {
+        return;
+    }
+
+    // Changes from here on are not guaranteed to make it into this store
+    m_storing = m_dirty;
+    m_dirty = 0;
+    m_due = QDeadlineTimer(QDeadlineTimer::Forever);
+    m_nextAllowed = QDeadlineTimer(minInterval);
+
+    qDebug() << "Autosave: storing wallet";
+    m_wallet->store();
+}
+
+void WalletAutosave::onStored(bool success, const QString &error) {
+    if (success) {
+        m_failures = 0;
+        m_storing = 0;
+        m_nextAllowed = QDeadlineTimer(minInterval);
+        this->schedule();
+        return;
+    }
+
+    // Whatever the store was meant to save is still unsaved, retry once the backoff allows it
+    m_failures++;
+    auto backoff = std::min<std::chrono::seconds>(minInterval * (1 << std::min(m_failures, 6)), maxBackoff);
+    m_nextAllowed = QDeadlineTimer(backoff);
+    m_dirty |= m_storing;
+    if (m_dirty == 0) {
+        // A store made for another reason failed, the cache may hold anything
+        m_dirty = 1u << Commit;
+    }
+    m_due = QDeadlineTimer(0);
+    qWarning() << "Autosave: store failed, retrying in" << backoff.count() << "seconds:" << error;
+
+    if (m_failures == maxFailures) {
+        emit failing(error);
+    }
+    this->schedule();
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#ifndef FEATHER_WALLETAUTOSAVE_H
+#define FEATHER_WALLETAUTOSAVE_H
+
+#include <QObject>
+#include <QDeadlineTimer>
+#include <QTimer>
+
+#include <chrono>
+
+class Wallet;
+
+// Stores the wallet cache some time after it changed, instead of on a fixed interval.
+//
+// Every kind of change has a latency, the longest it may stay unsaved. Changes made while a store
+// is due are saved by that store, and two stores are at least minInterval apart. A crash loses at
+// most latency + minInterval of changes, a store never happens if nothing changed.
+//
+// A failed store is retried with whatever it was meant to save. Retries back off up to maxBackoff,
+// failing maxFailures times in a row is reported once.
+class WalletAutosave : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Change {
+        Commit = 0, // a transaction was sent, its tx key only exists in the cache
+        Transfers,  // outputs received or spent
+        Notes,      // transaction notes
+        Labels,     // subaddress and account labels, contacts
+        Attributes, // cache attributes, pinned and hidden addresses
+        Blocks,     // scan progress, only marked once synchronized
+        COUNT
+    };
+
+    //! may be called from any thread
+    void markDirty(Change change);
+
+    static constexpr std::chrono::seconds minInterval{15};
+    static constexpr std::chrono::seconds maxBackoff{600};
+    static constexpr int maxFailures = 3;
+    static std::chrono::seconds latency(Change change);
+
+signals:
+    //! stores kept failing, emitted once until a store succeeds again
+    void failing(const QString &error);
+
+private:
+    explicit WalletAutosave(Wallet *wallet, QObject *parent);
+    friend class Wallet;
+
+    void onStored(bool success, const QString &error);
+    void schedule();
+    void store();
+
+    Wallet *m_wallet;
+    QTimer *m_timer;
+
+    quint32 m_dirty = 0;         // bit per Change
+    quint32 m_storing = 0;       // m_dirty of the last store, restored if it fails
+    int m_failures = 0;          // in a row
+    QDeadlineTimer m_due{QDeadlineTimer::Forever};
+    QDeadlineTimer m_nextAllowed; // minInterval after the last store
+};
+
+#endif //FEATHER_WALLETAUTOSAVE_H
@@ -58,7 +58,8 @@ void WalletListenerImpl::updated()
 void WalletListenerImpl::refreshed(bool success)
 {
     QString message = m_wallet->errorString();
-    emit m_wallet->refreshed(success, message);
+    bool interrupted = m_wallet->m_refreshInterrupted.exchange(false);
+    emit m_wallet->refreshed(success, interrupted, message);
 }
 
 void WalletListenerImpl::onDeviceButtonRequest(uint64_t code)
@@ -0,0 +1,237 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include "WalletSearch.h"
+
+#include <algorithm>
+
+#include "AddressBook.h"
+#include "Coins.h"
+#include "Subaddress.h"
+#include "TransactionHistory.h"
+#include "Wallet.h"
+#include "utils/Utils.h"
+
+WalletSearch::WalletSearch(Wallet *wallet, QObject *parent)
+        : QObject(parent)
+        , m_wallet(wallet)
+{
+    Coins *coins = m_wallet->coins();
+    connect(coins, &Coins::refreshFinished, this, [this]{
+        m_coins.dirty = true;
+    });
+    connect(coins, &Coins::rowsAboutToChange, this, &WalletSearch::onCoinsAboutToChange);
+    connect(coins, &Coins::rowsChanged, this, &WalletSearch::onCoinsChanged);
+
+    // Subaddresses and contacts are small enough to index again on the next query
+    Subaddress *subaddress = m_wallet->subaddress();
+    auto subaddressesChanged = [this]{
+        m_subaddresses.dirty = true;
+    };
+    connect(subaddress, &Subaddress::refreshFinished, this, subaddressesChanged);
+    connect(subaddress, &Subaddress::rowsChanged, this, subaddressesChanged);
+    connect(subaddress, &Subaddress::rowUpdated, this, subaddressesChanged);
+    connect(subaddress, &Subaddress::endAddRow, this, subaddressesChanged);
+
+    connect(m_wallet->addressBook(), &AddressBook::refreshFinished, this, [this]{
+        m_contacts.dirty = true;
+    });
+}
+
+void WalletSearch::Entity::set(quint64 id, Document document) {
+    auto it = documents.find(id);
+    if (it != documents.end()) {
+        if (it->text == document.text) {
+            it->result = std::move(document.result);
+            return;
+        }
+        index.remove(id, it->text);
+    }
+    index.insert(id, document.text);
+    documents.insert(id, std::move(document));
+}
+
+void WalletSearch::Entity::take(quint64 id) {
+    auto it = documents.find(id);
+    if (it == documents.end()) {
+        return;
+    }
+    index.remove(id, it->text);
+    documents.erase(it);
+}
+
+void WalletSearch::Entity::clear() {
+    index.clear();
+    documents.clear();
+}
+
+QList<WalletSearch::Result> WalletSearch::find(const QString &query, qsizetype limit) {
+    QList<Result> results;
+    QString needle = query.trimmed();
+    if (needle.size() < 3) {
+        return results;
+    }
+
+    // History may not have been built yet, it's found by later queries
+    m_wallet->history()->load();
+
+    if (m_coins.dirty) {
+        this->indexCoins();
+    }
+    if (m_subaddresses.dirty) {
+        this->indexSubaddresses();
+    }
+    if (m_contacts.dirty) {
+        this->indexContacts();
+    }
+
+    this->findTransactions(needle, limit, results);
+    this->findIn(m_coins, needle, limit, results);
+    this->findIn(m_subaddresses, needle, limit, results);
+    this->findIn(m_contacts, needle, limit, results);
+    return results;
+}
+
+void WalletSearch::onCoinsAboutToChange(const RowDelta &delta) {
+    if (m_coins.dirty || delta.type != RowDelta::Removed) {
+        return;
+    }
+
+    Coins *coins = m_wallet->coins();
+    for (qsizetype i = delta.first; i <= delta.last; ++i) {
+        m_coins.take(coins->getRow(i).transferIndex);
+    }
+}
+
+void WalletSearch::onCoinsChanged(const RowDelta &delta) {
+    if (m_coins.dirty || delta.type == RowDelta::Removed) {
+        return;
+    }
+
+    Coins *coins = m_wallet->coins();
+    for (qsizetype i = delta.first; i <= delta.last; ++i) {
+        m_coins.set(coins->getRow(i).transferIndex, this->coinDocument(i));
+    }
+}
+
+WalletSearch::Document WalletSearch::coinDocument(qsizetype row) const {
+    Coins *coins = m_wallet->coins();
+    const CoinsInfo &coin = coins->getRow(row);
+
+    QStringList fields{coin.pk.toHex(), coin.txid.toHex()};
+    if (coin.keyImageKnown) {
+        fields << coin.ki.toHex();
+    }
+    fields << coins->address(coin) << coin.addressLabel << coin.description << coin.txNote;
+
+    QString summary = QString("%1 XMR").arg(coin.displayAmount());
+    QString label = coin.description.isEmpty() ? coin.addressLabel : coin.description;
+    if (!label.isEmpty()) {
+        summary += QString(" (%1)").arg(label);
+    }
+
+    return {fields.join("\n"), {Result::Coin, coin.pubKey(), summary}};
+}
+
+void WalletSearch::indexCoins() {
+    m_coins.clear();
+    Coins *coins = m_wallet->coins();
+    for (qsizetype i = 0; i < coins->count(); ++i) {
+        m_coins.set(coins->getRow(i).transferIndex, this->coinDocument(i));
+    }
+    m_coins.dirty = false;
+}
+
+void WalletSearch::indexSubaddresses() {
+    m_subaddresses.clear();
+    const QList<SubaddressRow> &rows = m_wallet->subaddress()->getRows();
+    for (qsizetype i = 0; i < rows.size(); ++i) {
+        const SubaddressRow &row = rows[i];
+        QString summary = QString("#%1 %2").arg(QString::number(i), row.label.isEmpty() ? Utils::displayAddress(row.address, 1) : row.label);
+        m_subaddresses.set(i, {row.address + "\n" + row.label, {Result::Subaddress, row.address, summary}});
+    }
+    m_subaddresses.dirty = false;
+}
+
+void WalletSearch::indexContacts() {
+    m_contacts.clear();
+    const QList<ContactRow> &rows = m_wallet->addressBook()->getRows();
+    for (qsizetype i = 0; i < rows.size(); ++i) {
+        const ContactRow &row = rows[i];
+        m_contacts.set(i, {row.address + "\n" + row.label, {Result::Contact, row.address, row.label}});
+    }
+    m_contacts.dirty = false;
+}
+
+void WalletSearch::findTransactions(const QString &query, qsizetype limit, QList<Result> &results) {
+    TransactionHistory *history = m_wallet->history();
+    const qsizetype end = results.size() + limit;
+
+    auto match = [&query, &results](const TransactionRow &row) {
+        QString hash = row.hash();
+        if (!hash.contains(query, Qt::CaseInsensitive) && !row.description.contains(query, Qt::CaseInsensitive)
+                && !row.label.contains(query, Qt::CaseInsensitive)) {
+            return;
+        }
+
+        QString summary = QString("%1 %2 XMR").arg(row.date(), row.displayAmount());
+        QString label = row.description.isEmpty() ? row.label : row.description;
+        if (!label.isEmpty()) {
+            summary += QString(" (%1)").arg(label);
+        }
+        results.append({Result::Transaction, hash, summary});
+    };
+
+    const QSet<quint32> *candidates = history->searchCandidates(query);
+    if (!candidates) {
+        for (const TransactionRow &row : history->getRows()) {
+            if (results.size() >= end) {
+                return;
+            }
+            match(row);
+        }
+        return;
+    }
+
+    // Only the candidates are looked at. The index spans all accounts, rows of other accounts aren't shown.
+    // Ids ascend with the rows, sorting them keeps results in row order.
+    QList<quint32> ids(candidates->cbegin(), candidates->cend());
+    std::sort(ids.begin(), ids.end());
+
+    const QList<TransactionRow> &rows = history->getRows();
+    for (quint32 id : ids) {
+        if (results.size() >= end) {
+            return;
+        }
+        qsizetype i = history->rowOf(id);
+        if (i >= 0) {
+            match(rows[i]);
+        }
+    }
+}
+
+void WalletSearch::findIn(const Entity &entity, const QString &query, qsizetype limit, QList<Result> &results) {
+    if (limit <= 0) {
+        return;
+    }
+    const qsizetype end = results.size() + limit;
+
+    std::optional<QSet<quint64>> candidates = entity.index.candidates(query);
+    if (!candidates) {
+        return;
+    }
+
+    // Sets are unordered, keep results in a stable order
+    QList<quint64> ids(candidates->cbegin(), candidates->cend());
+    std::sort(ids.begin(), ids.end());
+
+    for (quint64 id : ids) {
+        if (results.size() >= end) {
+            return;
+        }
+        auto document = entity.documents.constFind(id);
+        if (document->text.contains(query, Qt::CaseInsensitive)) {
+            results.append(document->result);
+        }
+    }
+}
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#ifndef FEATHER_WALLETSEARCH_H
+#define FEATHER_WALLETSEARCH_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include "rows/RowDelta.h"
+#include "utils/TrigramIndex.h"
+
+class Wallet;
+
+// Finds txids, addresses, key images and labels in history, coins, subaddresses and contacts
+// of the current account with a single query.
+//
+// History shares the index TransactionHistory keeps for its own search box, the other entities
+// are indexed here. Coins are updated row by row as they change, subaddresses and contacts are
+// few and are indexed again on the next query after a change.
+class WalletSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Result {
+        enum Kind {
+            Transaction = 0,
+            Coin,
+            Subaddress,
+            Contact
+        };
+
+        Kind kind;
+        QString key;  // txid, output public key or address, matches the search box of the entity's tab
+        QString text; // one line summary
+    };
+
+    //! plain case-insensitive substring search, queries shorter than three characters find nothing.
+    //! Transactions are only found once the history has loaded, see TransactionHistory::loaded().
+    //! At most limit results of each kind are returned, so a common query can't crowd out the other tabs.
+    QList<Result> find(const QString &query, qsizetype limit = 20);
+
+private:
+    explicit WalletSearch(Wallet *wallet, QObject *parent);
+    friend class Wallet;
+
+    struct Document {
+        QString text; // what the query is matched against
+        Result result;
+    };
+
+    // Documents of one entity type, by an id that is stable across row moves
+    struct Entity {
+        TrigramIndex<quint64> index;
+        QHash<quint64, Document> documents;
+        bool dirty = true;
+
+        void set(quint64 id, Document document);
+        void take(quint64 id);
+        void clear();
+    };
+
+    void onCoinsAboutToChange(const RowDelta &delta);
+    void onCoinsChanged(const RowDelta &delta);
+    Document coinDocument(qsizetype row) const;
+
+    void indexCoins();
+    void indexSubaddresses();
+    void indexContacts();
+
+    // Both append at most limit results
+    void findTransactions(const QString &query, qsizetype limit, QList<Result> &results);
+    void findIn(const Entity &entity, const QString &query, qsizetype limit, QList<Result> &results);
+
+    Wallet *m_wallet;
+
+    Entity m_coins;        // by transfer index
+    Entity m_subaddresses; // by subaddress index
+    Entity m_contacts;     // by address book row
+};
+
+#endif //FEATHER_WALLETSEARCH_H
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include "WalletSyncCoordinator.h"
+
+#include <QThread>
+
+#include <algorithm>
+
+WalletSyncCoordinator::WalletSyncCoordinator()
+    : m_slots(std::max(2, QThread::idealThreadCount()))
+{
+}
+
+WalletSyncCoordinator* WalletSyncCoordinator::instance()
+{
+    // Refresh threads of several wallets may get here first
+    static WalletSyncCoordinator coordinator;
+    return &coordinator;
+}
+
+bool WalletSyncCoordinator::acquire(const Wallet *wallet, quint64 blocksBehind)
+{
+    QMutexLocker locker(&m_mutex);
+
+    Ticket ticket{wallet, blocksBehind, m_nextSeq++};
+    m_waiting.append(ticket);
+
+    while (!m_cancelled.contains(wallet) && !this->mayScan(ticket)) {
+        m_scanCondition.wait(&m_mutex);
+    }
+
+    m_waiting.removeIf([wallet](const Ticket &t) {
+        return t.wallet == wallet;
+    });
+
+    if (m_cancelled.contains(wallet)) {
+        // Whoever was queued behind us may be next now
+        m_scanCondition.wakeAll();
+        return false;
+    }
+
+    m_running.insert(wallet);
+    return true;
+}
+
+void WalletSyncCoordinator::release(const Wallet *wallet)
+{
+    QMutexLocker locker(&m_mutex);
+    m_running.remove(wallet);
+    m_scanCondition.wakeAll();
+}
+
+void WalletSyncCoordinator::cancel(const Wallet *wallet)
+{
+    QMutexLocker locker(&m_mutex);
+    m_cancelled.insert(wallet);
+    m_scanCondition.wakeAll();
+}
+
+void WalletSyncCoordinator::remove(const Wallet *wallet)
+{
+    // A new wallet may be allocated at the same address, forget everything about this one
+    QMutexLocker locker(&m_mutex);
+    m_cancelled.remove(wallet);
+    m_running.remove(wallet);
+    if (m_foreground == wallet) {
+        m_foreground = nullptr;
+    }
+    m_scanCondition.wakeAll();
+}
+
+void WalletSyncCoordinator::setForeground(const Wallet *wallet)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_foreground == wallet) {
+        return;
+    }
+    m_foreground = wallet;
+
+    // A waiting scan of this wallet may have become the next one
+    m_scanCondition.wakeAll();
+}
+
+WalletSyncCoordinator::Heights WalletSyncCoordinator::heights(const QString &node, const std::function<Heights()> &fetch)
+{
+    if (node.isEmpty()) {
+        return fetch();
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_nodes[node].fetching) {
+            m_heightsCondition.wait(&m_mutex);
+        }
+
+        NodeHeights &entry = m_nodes[node];
+        if (!entry.fresh.hasExpired()) {
+            return entry.heights;
+        }
+        entry.fetching = true;
+    }
+
+    Heights heights = fetch();
+
+    QMutexLocker locker(&m_mutex);
+    NodeHeights &entry = m_nodes[node];
+    entry.fetching = false;
+
+    // Failures are not shared, the next wallet asks again
+    if (heights.daemon > 0 && heights.target > 0) {
+        entry.heights = heights;
+        entry.fresh.setRemainingTime(heightsMaxAge);
+    }
+    m_heightsCondition.wakeAll();
+
+    return heights;
+}
+
+int WalletSyncCoordinator::slots() const
+{
+    return m_slots;
+}
+
+bool WalletSyncCoordinator::priority(const Ticket &ticket) const
+{
+    return ticket.wallet == m_foreground || ticket.blocksBehind <= nearTipBlocks;
+}
+
+bool WalletSyncCoordinator::mayScan(const Ticket &ticket) const
+{
+    // Called with m_mutex held. Only the first waiting ticket may scan: priority tickets first, then in
+    // the order they were queued. Priority is looked at every time, the foreground wallet may change.
+    bool ticketPriority = this->priority(ticket);
+    for (const auto &other : m_waiting) {
+        if (other.seq == ticket.seq) {
+            continue;
+        }
+        bool otherPriority = this->priority(other);
+        if (otherPriority != ticketPriority ? otherPriority : other.seq < ticket.seq) {
+            return false;
+        }
+    }
+
+    int running = m_running.size();
+    return ticketPriority ? running < m_slots : running < m_slots - 1;
+}
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#ifndef FEATHER_WALLETSYNCCOORDINATOR_H
+#define FEATHER_WALLETSYNCCOORDINATOR_H
+
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QWaitCondition>
+
+#include <chrono>
+#include <functional>
+
+class Wallet;
+
+// Decides which of the open wallets may scan, shared by the refresh threads of all wallets.
+//
+// At most slots() scans run at once. The last slot is kept for the foreground wallet and for wallets
+// near the tip, their scans are short and shouldn't wait for a background wallet catching up on weeks
+// of blocks. Wallets on the same node share daemon and target height queries.
+class WalletSyncCoordinator
+{
+public:
+    struct Heights {
+        quint64 daemon = 0;
+        quint64 target = 0;
+    };
+
+    static WalletSyncCoordinator* instance();
+
+    //! blocks until wallet may scan, false if cancel() was called for it
+    bool acquire(const Wallet *wallet, quint64 blocksBehind);
+    void release(const Wallet *wallet);
+
+    //! acquire() returns false from now on, called when the refresh thread stops
+    void cancel(const Wallet *wallet);
+    //! called once the refresh thread has finished
+    void remove(const Wallet *wallet);
+
+    //! the wallet of the window last activated
+    void setForeground(const Wallet *wallet);
+
+    //! fetch is only called if no other wallet on node asked recently, concurrent callers wait for its result
+    Heights heights(const QString &node, const std::function<Heights()> &fetch);
+
+    [[nodiscard]] int slots() const;
+
+    static constexpr quint64 nearTipBlocks = 100;
+    static constexpr std::chrono::seconds heightsMaxAge{5};
+
+private:
+    WalletSyncCoordinator();
+
+    struct Ticket {
+        const Wallet *wallet;
+        quint64 blocksBehind;
+        quint64 seq;
+    };
+
+    struct NodeHeights {
+        Heights heights;
+        QDeadlineTimer fresh;
+        bool fetching = false;
+    };
+
+    [[nodiscard]] bool priority(const Ticket &ticket) const;
+    [[nodiscard]] bool mayScan(const Ticket &ticket) const;
+
+    const int m_slots;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_scanCondition;
+    QWaitCondition m_heightsCondition;
+
+    QList<Ticket> m_waiting;
+    QSet<const Wallet*> m_running;
+    QSet<const Wallet*> m_cancelled;
+    const Wallet *m_foreground = nullptr;
+    quint64 m_nextSeq = 0;
+
+    QHash<QString, NodeHeights> m_nodes; // by daemon address
+};
+
+inline WalletSyncCoordinator* syncCoordinator()
+{
+    return WalletSyncCoordinator::instance();
+}
+
+#endif //FEATHER_WALLETSYNCCOORDINATOR_H
@@ -9,6 +9,18 @@ QString CoinsInfo::displayAmount() const
     return WalletManager::displayAmount(amount);
 }
 
+QString CoinsInfo::hash() const {
+    return txid.toString();
+}
+
+QString CoinsInfo::keyImage() const {
+    return ki.toString();
+}
+
+QString CoinsInfo::pubKey() const {
+    return pk.toString();
+}
+
 QString CoinsInfo::getAddressLabel() const {
     if (subaddrIndex == 0) {
         if (coinbase) {
@@ -24,29 +36,3 @@ QString CoinsInfo::getAddressLabel() const {
 
     return addressLabel;
 }
-
-
-void CoinsInfo::setUnlocked(bool unlocked_) {
-    unlocked = unlocked_;
-}
-
-CoinsInfo::CoinsInfo()
-        : blockHeight(0)
-        , internalOutputIndex(0)
-        , globalOutputIndex(0)
-        , spent(false)
-        , frozen(false)
-        , spentHeight(0)
-        , amount(0)
-        , rct(false)
-        , keyImageKnown(false)
-        , pkIndex(0)
-        , subaddrIndex(0)
-        , subaddrAccount(0)
-        , unlockTime(0)
-        , unlocked(false)
-        , coinbase(false)
-        , change(false)
-{
-
-}
@@ -6,10 +6,13 @@
 
 #include <QString>
 
+#include "HexKey.h"
+
 struct CoinsInfo
 {
+    quint64 transferIndex; // index into wallet2's transfer details
     quint64 blockHeight;
-    QString hash;
+    HexKey txid;
     quint64 internalOutputIndex;
     quint64 globalOutputIndex;
     bool spent;
@@ -21,22 +24,48 @@ struct CoinsInfo
     quint64 pkIndex;
     quint32 subaddrIndex;
     quint32 subaddrAccount;
-    QString address;
     QString addressLabel;
-    QString keyImage;
+    HexKey ki; // key image, only meaningful if keyImageKnown
     quint64 unlockTime;
-    bool unlocked;
-    QString pubKey;
+    quint64 unlockHeight; // wallet height at which the output becomes spendable
+    HexKey pk; // output public key
     bool coinbase;
     QString description;
     bool change;
     QString txNote;
 
+    QString hash() const;
+    QString keyImage() const;
+    QString pubKey() const;
     QString getAddressLabel() const;
     QString displayAmount() const;
-    void setUnlocked(bool unlocked);
 
-    explicit CoinsInfo();
+    // Inline, so code that only weighs coins doesn't depend on WalletManager
+    bool unlocked(quint64 walletHeight) const {
+        return walletHeight >= unlockHeight;
+    }
+
+    explicit CoinsInfo()
+            : transferIndex(0)
+            , blockHeight(0)
+            , internalOutputIndex(0)
+            , globalOutputIndex(0)
+            , spent(false)
+            , frozen(false)
+            , spentHeight(0)
+            , amount(0)
+            , rct(false)
+            , keyImageKnown(false)
+            , pkIndex(0)
+            , subaddrIndex(0)
+            , subaddrAccount(0)
+            , unlockTime(0)
+            , unlockHeight(0)
+            , coinbase(false)
+            , change(false)
+    {
+
+    }
 };
 
 #endif //FEATHER_COINSINFO_H
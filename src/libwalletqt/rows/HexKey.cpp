@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include "HexKey.h"
+
+#include <QCache>
+#include <QMutex>
+
+namespace {
+    // Enough for the rows on screen and a couple of dialogs, views ask for the same keys on every repaint
+    constexpr qsizetype cacheSize = 2048;
+
+    QMutex cacheMutex;
+    QCache<HexKey, QString> cache(cacheSize);
+}
+
+QString HexKey::toString() const
+{
+    QMutexLocker locker(&cacheMutex);
+    if (const QString *hex = cache.object(*this)) {
+        return *hex;
+    }
+
+    QString hex = this->toHex();
+    cache.insert(*this, new QString(hex));
+    return hex;
+}
+
+QString HexKey::toHex() const
+{
+    return QString::fromLatin1(QByteArray::fromRawData(reinterpret_cast<const char*>(bytes.data()), bytes.size()).toHex());
+}
+
+bool HexKey::isNull() const
+{
+    return bytes == std::array<uchar, 32>{};
+}
+
+HexKey HexKey::fromHex(const QString &hex, bool *ok)
+{
+    HexKey key;
+    QByteArray latin = hex.toLatin1();
+    QByteArray data = QByteArray::fromHex(latin);
+    // fromHex() skips characters it doesn't know, an odd number of digits still makes 32 bytes
+    bool valid = hex.size() == 2 * qsizetype(key.bytes.size()) && data.size() == qsizetype(key.bytes.size())
+                 && data.toHex() == latin.toLower();
+    if (valid) {
+        std::memcpy(key.bytes.data(), data.constData(), key.bytes.size());
+    }
+    if (ok) {
+        *ok = valid;
+    }
+    return key;
+}
+
+size_t qHash(const HexKey &key, size_t seed) noexcept
+{
+    return qHashBits(key.bytes.data(), key.bytes.size(), seed);
+}
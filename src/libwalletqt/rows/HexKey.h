@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#ifndef FEATHER_HEXKEY_H
+#define FEATHER_HEXKEY_H
+
+#include <QString>
+
+#include <array>
+#include <cstring>
+
+// A 32 byte hash or key (txid, key image, output public key), kept in binary and formatted on demand
+struct HexKey
+{
+    std::array<uchar, 32> bytes{};
+
+    //! lowercase hex, the most recently formatted keys are cached
+    QString toString() const;
+    //! lowercase hex, bypasses the cache for bulk formatting
+    QString toHex() const;
+    bool isNull() const;
+
+    static HexKey fromHex(const QString &hex, bool *ok = nullptr);
+
+    template <typename Pod>
+    static HexKey fromPod(const Pod &pod) {
+        static_assert(sizeof(Pod) == sizeof(bytes), "HexKey holds 32 byte values only");
+        HexKey key;
+        std::memcpy(key.bytes.data(), &pod, sizeof(bytes));
+        return key;
+    }
+
+    bool operator==(const HexKey &other) const {
+        return bytes == other.bytes;
+    }
+    bool operator!=(const HexKey &other) const {
+        return bytes != other.bytes;
+    }
+};
+
+size_t qHash(const HexKey &key, size_t seed = 0) noexcept;
+
+#endif //FEATHER_HEXKEY_H
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#ifndef FEATHER_ROWDELTA_H
+#define FEATHER_ROWDELTA_H
+
+#include <QHash>
+#include <QList>
+
+#include <utility>
+
+// A contiguous range of rows touched by an incremental refresh
+struct RowDelta
+{
+    enum Type {
+        Inserted,
+        Updated,
+        Removed
+    };
+
+    Type type;
+    qsizetype first;
+    qsizetype last;
+};
+
+// Turns rows into newRows with the minimal set of removals, insertions and updates.
+// Rows are matched by key(row), matched rows that differ according to equal(a, b) are replaced.
+// aboutToChange(delta) and changed(delta) are called around every change, like
+// QAbstractItemModel's begin/end pairs.
+//
+// newRows is consumed. Matched rows must keep their relative order, otherwise both lists are left
+// untouched and false is returned so the caller can fall back to a reset.
+template <typename Row, typename KeyFn, typename EqualFn, typename AboutToChangeFn, typename ChangedFn>
+bool applyRowDiff(QList<Row> &rows, QList<Row> &newRows, KeyFn key, EqualFn equal,
+                  AboutToChangeFn aboutToChange, ChangedFn changed)
+{
+    using Key = decltype(key(std::declval<const Row&>()));
+
+    QHash<Key, qsizetype> newIndex;
+    newIndex.reserve(newRows.size());
+    for (qsizetype i = 0; i < newRows.size(); ++i) {
+        newIndex.insert(key(newRows[i]), i);
+    }
+
+    // Position in newRows of every old row, -1 if it is gone
+    QList<qsizetype> matched(rows.size(), -1);
+    qsizetype previous = -1;
+    for (qsizetype i = 0; i < rows.size(); ++i) {
+        auto it = newIndex.constFind(key(rows[i]));
+        if (it == newIndex.constEnd()) {
+            continue;
+        }
+        if (it.value() <= previous) {
+            return false;
+        }
+        matched[i] = previous = it.value();
+    }
+
+    // Removals, back to front so the ranges stay valid
+    for (qsizetype end = rows.size() - 1; end >= 0;) {
+        if (matched[end] >= 0) {
+            --end;
+            continue;
+        }
+
+        qsizetype begin = end;
+        while (begin > 0 && matched[begin - 1] < 0) {
+            --begin;
+        }
+
+        RowDelta delta{RowDelta::Removed, begin, end};
+        aboutToChange(delta);
+        rows.remove(begin, end - begin + 1);
+        matched.remove(begin, end - begin + 1);
+        changed(delta);
+
+        end = begin - 1;
+    }
+
+    // rows is now a subsequence of newRows: insert the gaps, replace what differs
+    QList<qsizetype> updated;
+    qsizetype i = 0;
+    for (qsizetype j = 0; j < newRows.size();) {
+        if (i < rows.size() && matched[i] == j) {
+            if (!equal(rows[i], newRows[j])) {
+                rows[i] = std::move(newRows[j]);
+                updated.append(i);
+            }
+            ++i;
+            ++j;
+            continue;
+        }
+
+        qsizetype count = 0;
+        while (j + count < newRows.size() && (i >= rows.size() || matched[i] != j + count)) {
+            ++count;
+        }
+
+        RowDelta delta{RowDelta::Inserted, i, i + count - 1};
+        aboutToChange(delta);
+        for (qsizetype k = 0; k < count; ++k) {
+            rows.insert(i + k, std::move(newRows[j + k]));
+        }
+        matched.insert(i, count, -1);
+        changed(delta);
+
+        i += count;
+        j += count;
+    }
+
+    for (qsizetype begin = 0; begin < updated.size();) {
+        qsizetype end = begin;
+        while (end + 1 < updated.size() && updated[end + 1] == updated[end] + 1) {
+            ++end;
+        }
+
+        RowDelta delta{RowDelta::Updated, updated[begin], updated[end]};
+        aboutToChange(delta);
+        changed(delta);
+        begin = end + 1;
+    }
+
+    return true;
+}
+
+#endif //FEATHER_ROWDELTA_H
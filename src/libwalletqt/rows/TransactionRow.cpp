@@ -3,14 +3,13 @@
 
 #include "TransactionRow.h"
 #include "WalletManager.h"
-#include "Output.h"
 
 TransactionRow::TransactionRow()
         : amount(0)
         , balanceDelta(0)
         , blockHeight(0)
-        , confirmations(0)
         , direction(TransactionRow::Direction_Out)
+        , id(0)
         , subaddrAccount(0)
         , unlockTime(0)
         , failed(false)
@@ -20,6 +19,11 @@ TransactionRow::TransactionRow()
 {
 }
 
+QString TransactionRow::hash() const
+{
+    return txid.toString();
+}
+
 double TransactionRow::amountDouble() const
 {
     return displayAmount().toDouble();
@@ -37,41 +41,33 @@ QString TransactionRow::displayFee() const
     return WalletManager::displayAmount(fee);
 }
 
-quint64 TransactionRow::confirmationsRequired() const
+quint64 TransactionRow::confirmations(quint64 walletHeight) const
 {
-    return (blockHeight < unlockTime) ? unlockTime - blockHeight : 10;
+    if (pending) {
+        return 0;
+    }
+    return (walletHeight > blockHeight) ? walletHeight - blockHeight : 0;
 }
 
-QString TransactionRow::date() const
+quint64 TransactionRow::confirmationsRequired() const
 {
-    return timestamp.date().toString(Qt::ISODate);
+    return (blockHeight < unlockTime) ? unlockTime - blockHeight : 10;
 }
 
-QString TransactionRow::time() const
+bool TransactionRow::maturing(quint64 walletHeight) const
 {
-    return timestamp.time().toString(Qt::ISODate);
+    // Confirmed, but the clock icon still changes with every block
+    return !pending && confirmations(walletHeight) < confirmationsRequired();
 }
 
-QList<QString> TransactionRow::destinations() const
+QString TransactionRow::date() const
 {
-    QList<QString> dests;
-    for (auto const& t: transfers) {
-        dests.append(t.address);
-    }
-    return dests;
+    return timestamp.date().toString(Qt::ISODate);
 }
 
-QString TransactionRow::rings_formatted() const
+QString TransactionRow::time() const
 {
-    QString ringsStr;
-    for (auto const& r: rings) {
-        ringsStr += r.keyImage + ": \n";
-        for (uint64_t m : r.ringMembers){
-            ringsStr += QString::number(m) + " ";
-        }
-        ringsStr += "\n\n";
-    }
-    return ringsStr;
+    return timestamp.time().toString(Qt::ISODate);
 }
 
 bool TransactionRow::hasPaymentId() const {
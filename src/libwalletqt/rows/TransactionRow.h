@@ -7,6 +7,8 @@
 #include <QSet>
 #include <QDateTime>
 
+#include "HexKey.h"
+
 struct Ring
 {
     QString keyImage;
@@ -16,8 +18,6 @@ struct Ring
         : keyImage(std::move(keyImage))
         , ringMembers(std::move(ringMembers)) {}
 };
-struct Output;
-
 struct TransactionRow
 {
     enum Direction {
@@ -26,15 +26,13 @@ struct TransactionRow
         Direction_Both // invalid direction value, used for filtering
     };
 
-    QList<Output> transfers;
-    QList<Ring> rings;
     qint64 amount; // Amount that was sent (to destinations) or received, excludes tx fee
     qint64 balanceDelta; // How much the total balance was mutated as a result of this tx (includes tx fee)
     quint64 blockHeight;
     QString description;
-    quint64 confirmations;
     Direction direction;
-    QString hash;
+    HexKey txid;
+    quint32 id; // identifies the row in the search index
     QString label;
     QString paymentId;
     quint32 subaddrAccount;
@@ -46,14 +44,15 @@ struct TransactionRow
     bool coinbase;
     quint64 fee;
 
+    QString hash() const;
     QString displayFee() const;
     QString displayAmount() const;
     double amountDouble() const;
+    quint64 confirmations(quint64 walletHeight) const;
     quint64 confirmationsRequired() const;
+    bool maturing(quint64 walletHeight) const;
     QString date() const;
     QString time() const;
-    QList<QString> destinations() const;
-    QString rings_formatted() const;
     bool hasPaymentId() const;
 
     explicit TransactionRow();
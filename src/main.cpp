@@ -1,11 +1,13 @@
 // SPDX-License-Identifier: BSD-3-Clause
 // SPDX-FileCopyrightText: The Monero Project
 
+#include <QElapsedTimer>
 #include <QSslSocket>
 
 #include "Application.h"
 #include "constants.h"
 #include "utils/EventFilter.h"
+#include "utils/StartupProfiler.h"
 #include "WindowManager.h"
 #include "config.h"
 #include <wallet/api/wallet2_api.h>
@@ -60,6 +62,9 @@ void signal_handler(int signum) {
 
 int main(int argc, char *argv[])
 {
+    QElapsedTimer startupClock;
+    startupClock.start();
+
     Q_INIT_RESOURCE(assets);
 
 #if defined(Q_OS_LINUX) && defined(STACK_TRACE)
@@ -105,6 +110,20 @@ if (AttachConsole(ATTACH_PARENT_PROCESS)) {
     QCommandLineOption testnetOption("testnet", "Testnet is for development purposes only.");
     parser.addOption(testnetOption);
 
+    QCommandLineOption configDirOption("config-dir", "Keep config, logs and new wallets in <dir> instead of the default location.", "dir");
+    parser.addOption(configDirOption);
+
+    QCommandLineOption offlineOption("offline", "Start in offline mode, don't connect to a node.");
+    parser.addOption(offlineOption);
+
+    QCommandLineOption startupReportOption("startup-report", "Write startup timings as JSON to <file>.", "file");
+    parser.addOption(startupReportOption);
+
+    QCommandLineOption benchmarkStartupOption("benchmark-startup", "Open <wallet> with an empty password, write the startup report and quit after the first sync status, "
+                                                                   "or once the wallet is loaded with --offline. "
+                                                                   "Set QT_QPA_PLATFORM=offscreen to run headless.", "wallet");
+    parser.addOption(benchmarkStartupOption);
+
     parser.process(app);
 
     if (parser.isSet(versionOption) || parser.isSet(helpOption)) {
@@ -116,10 +135,25 @@ if (AttachConsole(ATTACH_PARENT_PROCESS)) {
         return EXIT_SUCCESS;
     }
 
+    if (parser.isSet(configDirOption)) {
+        Config::setConfigDir(parser.value(configDirOption));
+    }
+
     bool stagenet = parser.isSet(stagenetOption);
     bool testnet = parser.isSet(testnetOption);
     bool quiet = parser.isSet(quietModeOption);
 
+    bool benchmarkStartup = parser.isSet(benchmarkStartupOption);
+    if (parser.isSet(startupReportOption) || benchmarkStartup) {
+        QString reportPath = parser.value(startupReportOption);
+        if (reportPath.isEmpty()) {
+            reportPath = QString("%1/startup_report.json").arg(Config::defaultConfigDir().path());
+        }
+        startupProfiler()->start(startupClock, reportPath);
+        startupProfiler()->setBenchmarkWallet(parser.value(benchmarkStartupOption));
+        startupProfiler()->mark(StartupProfiler::ApplicationReady);
+    }
+
     // Setup networkType
     if (stagenet)
         constants::networkType = NetworkType::STAGENET;
@@ -178,6 +212,14 @@ if (AttachConsole(ATTACH_PARENT_PROCESS)) {
     if (parser.isSet("use-local-tor"))
         conf()->set(Config::useLocalTor, true);
 
+    if (parser.isSet(offlineOption))
+        conf()->set(Config::offlineMode, true);
+
+    // Offline there is no sync status to wait for
+    if (conf()->get(Config::offlineMode).toBool()) {
+        startupProfiler()->setFinalMilestone(StartupProfiler::ModelsReady);
+    }
+
     conf()->set(Config::restartRequired, false);
 
     if (!quiet) {
@@ -202,6 +244,8 @@ if (AttachConsole(ATTACH_PARENT_PROCESS)) {
     QApplication::setFont(fontDef);
 #endif
 
+    startupProfiler()->mark(StartupProfiler::ConfigReady);
+
     qInstallMessageHandler(Utils::applicationLogHandler);
     qRegisterMetaType<QVector<QString>>();
     qRegisterMetaType<TxProofResult>("TxProofResult");
@@ -217,8 +261,19 @@ if (AttachConsole(ATTACH_PARENT_PROCESS)) {
 
     auto wm = windowManager();
     wm->setEventFilter(&filter);
+    startupProfiler()->mark(StartupProfiler::WindowManagerReady);
+
+    if (benchmarkStartup) {
+        QObject::connect(startupProfiler(), &StartupProfiler::finished, wm, &WindowManager::close);
+    }
 
     int exitCode = Application::exec();
     qDebug() << "Application::exec() returned";
+
+    // Let a benchmark run fail if the final milestone was never reached
+    if (benchmarkStartup && exitCode == EXIT_SUCCESS && !startupProfiler()->complete()) {
+        qWarning() << "Startup benchmark did not complete";
+        return EXIT_FAILURE;
+    }
     return exitCode;
 }
@@ -18,6 +18,42 @@ CoinsModel::CoinsModel(QObject *parent, Coins *coins)
 {
     connect(m_coins, &Coins::refreshStarted, this, &CoinsModel::beginResetModel);
     connect(m_coins, &Coins::refreshFinished, this, &CoinsModel::endResetModel);
+    connect(m_coins, &Coins::rowsAboutToChange, this, &CoinsModel::onRowsAboutToChange);
+    connect(m_coins, &Coins::rowsChanged, this, &CoinsModel::onRowsChanged);
+
+    // Only the highlight depends on the selection
+    connect(m_coins->selection(), &CoinSelection::changed, this, [this]{
+        emit dataChanged(this->index(0, 0), this->index(this->rowCount() - 1, CoinsModel::COUNT - 1), {Qt::BackgroundRole});
+    });
+}
+
+void CoinsModel::onRowsAboutToChange(const RowDelta &delta)
+{
+    switch (delta.type) {
+        case RowDelta::Inserted:
+            this->beginInsertRows(QModelIndex(), delta.first, delta.last);
+            break;
+        case RowDelta::Removed:
+            this->beginRemoveRows(QModelIndex(), delta.first, delta.last);
+            break;
+        case RowDelta::Updated:
+            break;
+    }
+}
+
+void CoinsModel::onRowsChanged(const RowDelta &delta)
+{
+    switch (delta.type) {
+        case RowDelta::Inserted:
+            this->endInsertRows();
+            break;
+        case RowDelta::Removed:
+            this->endRemoveRows();
+            break;
+        case RowDelta::Updated:
+            emit dataChanged(this->index(delta.first, 0), this->index(delta.last, CoinsModel::COUNT - 1));
+            break;
+    }
 }
 
 int CoinsModel::rowCount(const QModelIndex &parent) const
@@ -45,7 +81,7 @@ QVariant CoinsModel::data(const QModelIndex &index, int role) const
     }
     const CoinsInfo& row = rows[index.row()];
 
-    bool selected = row.keyImageKnown && m_selected.contains(row.keyImage);
+    bool selected = row.keyImageKnown && m_coins->selection()->contains(row.ki);
 
     if(role == Qt::DisplayRole || role == Qt::EditRole || role == Qt::UserRole) {
         return parseTransactionInfo(row, index.column(), role);
@@ -57,7 +93,7 @@ QVariant CoinsModel::data(const QModelIndex &index, int role) const
         if (row.frozen) {
             return QBrush(ColorScheme::BLUE.asColor(true));
         }
-        if (!row.unlocked) {
+        if (!row.unlocked(m_coins->height())) {
             return QBrush(ColorScheme::YELLOW.asColor(true));
         }
         if (selected) {
@@ -102,7 +138,7 @@ QVariant CoinsModel::data(const QModelIndex &index, int role) const
         if (row.frozen) {
             return "Output is frozen.";
         }
-        if (!row.unlocked) {
+        if (!row.unlocked(m_coins->height())) {
             return "Output is locked (needs more confirmations)";
         }
         if (row.spent) {
@@ -165,7 +201,7 @@ bool CoinsModel::setData(const QModelIndex &index, const QVariant &value, int ro
     if (index.isValid() && role == Qt::EditRole) {
         const CoinsInfo& row = m_coins->getRow(index.row());
 
-        QString pubkey = row.pubKey;
+        QString pubkey = row.pubKey();
 
         switch (index.column()) {
             case Label:
@@ -190,13 +226,13 @@ QVariant CoinsModel::parseTransactionInfo(const CoinsInfo &cInfo, int column, in
         case KeyImageKnown:
             return "";
         case PubKey:
-            return cInfo.pubKey.mid(0,8);
+            return cInfo.pubKey().mid(0,8);
         case TxID:
-            return cInfo.hash.mid(0, 8) + " ";
+            return cInfo.hash().mid(0, 8) + " ";
         case BlockHeight:
             return cInfo.blockHeight;
         case Address:
-            return Utils::displayAddress(cInfo.address, 1, "");
+            return Utils::displayAddress(m_coins->address(cInfo), 1, "");
         case Label: {
             if (!cInfo.description.isEmpty())
                 return cInfo.description;
@@ -229,14 +265,6 @@ void CoinsModel::setCurrentSubaddressAccount(quint32 accountIndex) {
     m_currentSubaddressAccount = accountIndex;
 }
 
-void CoinsModel::setSelected(const QStringList &keyimages) {
-    m_selected.clear();
-    for (const auto &ki : keyimages) {
-        m_selected.insert(ki);
-    }
-    emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
-}
-
 const CoinsInfo& CoinsModel::entryFromIndex(const QModelIndex &index) const {
     Q_ASSERT(index.isValid() && index.row() < m_coins->count());
     return m_coins->getRow(index.row());
@@ -6,6 +6,8 @@
 
 #include <QAbstractTableModel>
 
+#include "libwalletqt/rows/RowDelta.h"
+
 class Coins;
 class CoinsInfo;
 
@@ -41,17 +43,19 @@ public:
     const CoinsInfo& entryFromIndex(const QModelIndex &index) const;
 
     void setCurrentSubaddressAccount(quint32 accountIndex);
-    void setSelected(const QStringList &selected);
 
 signals:
     void descriptionChanged();
 
+private slots:
+    void onRowsAboutToChange(const RowDelta &delta);
+    void onRowsChanged(const RowDelta &delta);
+
 private:
     QVariant parseTransactionInfo(const CoinsInfo &cInfo, int column, int role) const;
 
     Coins *m_coins;
     quint32 m_currentSubaddressAccount;
-    QSet<QString> m_selected;
 };
 
 #endif //FEATHER_COINSMODEL_H
@@ -33,8 +33,8 @@ bool CoinsProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceP
     }
 
     if (!m_searchRegExp.pattern().isEmpty()) {
-        return coin.pubKey.contains(m_searchRegExp) || coin.address.contains(m_searchRegExp)
-                || coin.hash.contains(m_searchRegExp) || coin.addressLabel.contains(m_searchRegExp)
+        return coin.pubKey().contains(m_searchRegExp) || m_coins->address(coin).contains(m_searchRegExp)
+                || coin.hash().contains(m_searchRegExp) || coin.addressLabel.contains(m_searchRegExp)
                 || coin.description.contains(m_searchRegExp);
     }
 
@@ -16,6 +16,9 @@ SubaddressAccountModel::SubaddressAccountModel(QObject *parent, SubaddressAccoun
 {
     connect(m_subaddressAccount, &SubaddressAccount::refreshStarted, this, &SubaddressAccountModel::startReset);
     connect(m_subaddressAccount, &SubaddressAccount::refreshFinished, this, &SubaddressAccountModel::endReset);
+    connect(m_subaddressAccount, &SubaddressAccount::balancesChanged, this, [this]{
+        emit dataChanged(this->index(0, Column::Balance), this->index(this->rowCount() - 1, Column::UnlockedBalance));
+    });
 }
 
 void SubaddressAccountModel::startReset(){
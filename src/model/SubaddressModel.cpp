@@ -22,6 +22,37 @@ SubaddressModel::SubaddressModel(QObject *parent, Subaddress *subaddress)
     connect(m_subaddress, &Subaddress::beginAddRow, this, &SubaddressModel::beginRowAdded);
     connect(m_subaddress, &Subaddress::endAddRow, this, &SubaddressModel::endInsertRows);
     connect(m_subaddress, &Subaddress::rowUpdated, this, &SubaddressModel::rowUpdated);
+    connect(m_subaddress, &Subaddress::rowsAboutToChange, this, &SubaddressModel::onRowsAboutToChange);
+    connect(m_subaddress, &Subaddress::rowsChanged, this, &SubaddressModel::onRowsChanged);
+}
+
+void SubaddressModel::onRowsAboutToChange(const RowDelta &delta)
+{
+    switch (delta.type) {
+        case RowDelta::Inserted:
+            this->beginInsertRows(QModelIndex(), delta.first, delta.last);
+            break;
+        case RowDelta::Removed:
+            this->beginRemoveRows(QModelIndex(), delta.first, delta.last);
+            break;
+        case RowDelta::Updated:
+            break;
+    }
+}
+
+void SubaddressModel::onRowsChanged(const RowDelta &delta)
+{
+    switch (delta.type) {
+        case RowDelta::Inserted:
+            this->endInsertRows();
+            break;
+        case RowDelta::Removed:
+            this->endRemoveRows();
+            break;
+        case RowDelta::Updated:
+            emit dataChanged(this->index(delta.first, 0), this->index(delta.last, SubaddressModel::COUNT - 1));
+            break;
+    }
 }
 
 int SubaddressModel::rowCount(const QModelIndex &parent) const
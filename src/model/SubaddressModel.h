@@ -6,6 +6,7 @@
 
 #include <QAbstractTableModel>
 
+#include "rows/RowDelta.h"
 #include "rows/SubaddressRow.h"
 
 class Subaddress;
@@ -39,6 +40,10 @@ public:
     void rowUpdated(qsizetype index);
     void beginRowAdded(qsizetype index);
 
+private slots:
+    void onRowsAboutToChange(const RowDelta &delta);
+    void onRowsChanged(const RowDelta &delta);
+
 private:
     Subaddress *m_subaddress;
     QVariant parseSubaddressRow(const SubaddressRow &subaddress, const QModelIndex &index, int role) const;
@@ -26,9 +26,42 @@ void TransactionHistoryModel::setTransactionHistory(TransactionHistory *th) {
     connect(m_transactionHistory, &TransactionHistory::refreshFinished,
             this, &TransactionHistoryModel::endResetModel);
 
+    // Incremental refreshes keep selection, scroll position and the proxy mapping intact
+    connect(m_transactionHistory, &TransactionHistory::rowsAboutToChange,
+            this, &TransactionHistoryModel::onRowsAboutToChange);
+    connect(m_transactionHistory, &TransactionHistory::rowsChanged,
+            this, &TransactionHistoryModel::onRowsChanged);
+
     emit transactionHistoryChanged();
 }
 
+void TransactionHistoryModel::onRowsAboutToChange(const RowDelta &delta) {
+    switch (delta.type) {
+        case RowDelta::Inserted:
+            beginInsertRows(QModelIndex(), delta.first, delta.last);
+            break;
+        case RowDelta::Removed:
+            beginRemoveRows(QModelIndex(), delta.first, delta.last);
+            break;
+        case RowDelta::Updated:
+            break;
+    }
+}
+
+void TransactionHistoryModel::onRowsChanged(const RowDelta &delta) {
+    switch (delta.type) {
+        case RowDelta::Inserted:
+            endInsertRows();
+            break;
+        case RowDelta::Removed:
+            endRemoveRows();
+            break;
+        case RowDelta::Updated:
+            emit dataChanged(this->index(delta.first, 0), this->index(delta.last, Column::COUNT - 1));
+            break;
+    }
+}
+
 const TransactionRow& TransactionHistoryModel::entryFromIndex(const QModelIndex &index) const {
     Q_ASSERT(index.isValid() && index.row() < m_transactionHistory->count());
     return m_transactionHistory->transaction(index.row());
@@ -71,21 +104,22 @@ QVariant TransactionHistoryModel::data(const QModelIndex &index, int role) const
         switch (index.column()) {
             case Column::Date:
             {
+                quint64 confirmations = tInfo.confirmations(m_transactionHistory->height());
                 if (tInfo.failed)
                     return QVariant(icons()->icon("warning.png"));
                 else if (tInfo.pending)
                     return QVariant(icons()->icon("unconfirmed.png"));
-                else if (tInfo.confirmations <= (1.0/5.0 * tInfo.confirmationsRequired()))
+                else if (confirmations <= (1.0/5.0 * tInfo.confirmationsRequired()))
                     return QVariant(icons()->icon("clock1.png"));
-                else if (tInfo.confirmations <= (2.0/5.0 * tInfo.confirmationsRequired()))
+                else if (confirmations <= (2.0/5.0 * tInfo.confirmationsRequired()))
                     return QVariant(icons()->icon("clock2.png"));
-                else if (tInfo.confirmations <= (3.0/5.0 * tInfo.confirmationsRequired()))
+                else if (confirmations <= (3.0/5.0 * tInfo.confirmationsRequired()))
                     return QVariant(icons()->icon("clock3.png"));
-                else if (tInfo.confirmations <= (4.0/5.0 * tInfo.confirmationsRequired()))
+                else if (confirmations <= (4.0/5.0 * tInfo.confirmationsRequired()))
                     return QVariant(icons()->icon("clock4.png"));
-                else if (tInfo.confirmations < tInfo.confirmationsRequired())
+                else if (confirmations < tInfo.confirmationsRequired())
                     return QVariant(icons()->icon("clock5.png"));
-                else if (tInfo.confirmations)
+                else if (confirmations)
                     return QVariant(icons()->icon("confirmed.svg"));
             }
         }
@@ -94,12 +128,13 @@ QVariant TransactionHistoryModel::data(const QModelIndex &index, int role) const
         switch(index.column()) {
             case Column::Date:
             {
+                quint64 confirmations = tInfo.confirmations(m_transactionHistory->height());
                 if (tInfo.failed)
                     return "Transaction failed";
-                else if (tInfo.confirmations < tInfo.confirmationsRequired())
-                    return QString("%1/%2 confirmations").arg(QString::number(tInfo.confirmations), QString::number(tInfo.confirmationsRequired()));
+                else if (confirmations < tInfo.confirmationsRequired())
+                    return QString("%1/%2 confirmations").arg(QString::number(confirmations), QString::number(tInfo.confirmationsRequired()));
                 else
-                    return QString("%1 confirmations").arg(QString::number(tInfo.confirmations));
+                    return QString("%1 confirmations").arg(QString::number(confirmations));
             }
         }
     }
@@ -154,9 +189,9 @@ QVariant TransactionHistoryModel::parseTransactionInfo(const TransactionRow &tIn
         }
         case Column::TxID: {
             if (conf()->get(Config::historyShowFullTxid).toBool()) {
-                return tInfo.hash;
+                return tInfo.hash();
             }
-            return Utils::displayAddress(tInfo.hash, 1);
+            return Utils::displayAddress(tInfo.hash(), 1);
         }
         case Column::FiatAmount:
         {
@@ -219,8 +254,7 @@ bool TransactionHistoryModel::setData(const QModelIndex &index, const QVariant &
             case Column::Description:
             {
                 const TransactionRow& row = m_transactionHistory->transaction(index.row());
-                m_transactionHistory->setTxNote(row.hash, value.toString());
-                m_transactionHistory->refresh();
+                m_transactionHistory->setTxNote(row.hash(), value.toString());
                 emit transactionDescriptionChanged();
                 break;
             }
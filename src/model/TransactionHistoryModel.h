@@ -7,6 +7,8 @@
 #include <QAbstractListModel>
 #include <QIcon>
 
+#include "libwalletqt/rows/RowDelta.h"
+
 class TransactionHistory;
 class TransactionRow;
 
@@ -45,6 +47,10 @@ signals:
     void transactionHistoryChanged();
     void transactionDescriptionChanged();
 
+private slots:
+    void onRowsAboutToChange(const RowDelta &delta);
+    void onRowsChanged(const RowDelta &delta);
+
 private:
     QVariant parseTransactionInfo(const TransactionRow &tInfo, int column, int role) const;
 
@@ -4,6 +4,7 @@
 #include "TransactionHistoryProxyModel.h"
 #include "TransactionHistoryModel.h"
 
+#include "libwalletqt/Subaddress.h"
 #include "libwalletqt/rows/TransactionRow.h"
 
 TransactionHistoryProxyModel::TransactionHistoryProxyModel(Wallet *wallet, QObject *parent)
@@ -13,6 +14,36 @@ TransactionHistoryProxyModel::TransactionHistoryProxyModel(Wallet *wallet, QObje
 {
     m_searchRegExp.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
     m_history = m_wallet->history();
+
+    connect(m_wallet, &Wallet::currentSubaddressAccountChanged, this, [this] {
+        if (!m_search.isEmpty()) {
+            this->findSubaddresses();
+            this->invalidateFilter();
+        }
+    });
+}
+
+void TransactionHistoryProxyModel::setSearchFilter(const QString &searchString) {
+    m_search = searchString;
+    m_searchRegExp.setPattern(searchString);
+    this->findSubaddresses();
+    invalidateFilter();
+}
+
+void TransactionHistoryProxyModel::findSubaddresses() {
+    // Addresses are matched once per query, rather than derived again for every row
+    m_subaddresses.clear();
+    if (m_search.isEmpty()) {
+        return;
+    }
+
+    bool plain = TrigramIndex<quint32>::isPlain(m_search);
+    const QList<SubaddressRow> &rows = m_wallet->subaddress()->getRows();
+    for (qsizetype i = 0; i < rows.size(); i++) {
+        if (plain ? rows[i].address.contains(m_search, Qt::CaseInsensitive) : rows[i].address.contains(m_searchRegExp)) {
+            m_subaddresses.insert(i);
+        }
+    }
 }
 
 TransactionHistory* TransactionHistoryProxyModel::history() {
@@ -25,20 +56,26 @@ bool TransactionHistoryProxyModel::filterAcceptsRow(int sourceRow, const QModelI
         return false;
     }
 
+    if (m_search.isEmpty()) {
+        return true;
+    }
+
     const TransactionRow& row = m_history->transaction(sourceRow);
 
-    QString description = row.description;
-    QString txid = row.hash;
-    QString subaddrlabel = row.label;
-    quint32 subaddrAccount = row.subaddrAccount;
-    QSet<quint32> subaddrIndex = row.subaddrIndex;
-
-    bool addressFound;
-    for (quint32 i : subaddrIndex) {
-        QString address = m_wallet->address(subaddrAccount, i);
-        addressFound = address.contains(m_searchRegExp);
-        if (addressFound) break;
+    for (quint32 i : row.subaddrIndex) {
+        if (m_subaddresses.contains(i)) {
+            return true;
+        }
     }
-    
-    return (description.contains(m_searchRegExp) || txid.contains(m_searchRegExp) || subaddrlabel.contains(m_searchRegExp)) || addressFound;
+
+    // Plain text queries are answered by the search index, rows it rules out are never looked at
+    if (const QSet<quint32> *candidates = m_history->searchCandidates(m_search)) {
+        if (!candidates->contains(row.id)) {
+            return false;
+        }
+        return row.description.contains(m_search, Qt::CaseInsensitive) || row.hash().contains(m_search, Qt::CaseInsensitive)
+               || row.label.contains(m_search, Qt::CaseInsensitive);
+    }
+
+    return row.description.contains(m_searchRegExp) || row.hash().contains(m_searchRegExp) || row.label.contains(m_searchRegExp);
 }
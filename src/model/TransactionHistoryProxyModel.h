@@ -18,16 +18,17 @@ public:
     TransactionHistory* history();
 
 public slots:
-    void setSearchFilter(const QString& searchString){
-        m_searchRegExp.setPattern(searchString);
-        invalidateFilter();
-    }
+    void setSearchFilter(const QString& searchString);
 
 private:
+    void findSubaddresses();
+
     Wallet *m_wallet;
     TransactionHistory *m_history;
 
+    QString m_search;
     QRegularExpression m_searchRegExp;
+    QSet<quint32> m_subaddresses; // subaddresses of the current account whose address matches
 };
 
 #endif //FEATHER_TRANSACTIONHISTORYPROXYMODEL_H
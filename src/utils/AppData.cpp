@@ -6,6 +6,7 @@
 #include <QCoreApplication>
 
 #include "config.h"
+#include "StartupProfiler.h"
 #include "WebsocketNotifier.h"
 
 AppData::AppData(QObject *parent)
@@ -36,6 +37,7 @@ void AppData::onBlockHeightsReceived(int mainnet, int stagenet) {
 }
 
 void AppData::initRestoreHeights() {
+    StartupProfiler::Span span("restore_heights");
     restoreHeights[NetworkType::TESTNET] = new RestoreHeightLookup(NetworkType::TESTNET);
     restoreHeights[NetworkType::STAGENET] = RestoreHeightLookup::fromFile(":/assets/restore_heights_monero_stagenet.txt", NetworkType::STAGENET);
     restoreHeights[NetworkType::MAINNET] = RestoreHeightLookup::fromFile(":/assets/restore_heights_monero_mainnet.txt", NetworkType::MAINNET);
@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include "StartupProfiler.h"
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QWidget>
+
+#include <algorithm>
+
+#include "version.h"
+
+namespace {
+    // An unreachable node never sends a sync status, don't wait for it forever
+    constexpr int reportTimeout = 5 * 60 * 1000;
+}
+
+StartupProfiler::Span::Span(const char *name)
+    : m_name(name)
+{
+    if (startupProfiler()->enabled()) {
+        m_start = startupProfiler()->elapsed();
+    }
+}
+
+StartupProfiler::Span::~Span()
+{
+    StartupProfiler *profiler = startupProfiler();
+    if (m_start < 0 || !profiler->enabled()) {
+        return;
+    }
+    profiler->m_spans.append({m_name, m_start, profiler->elapsed() - m_start});
+}
+
+StartupProfiler::StartupProfiler(QObject *parent)
+    : QObject(parent)
+{
+    std::fill(std::begin(m_milestones), std::end(m_milestones), -1);
+
+    m_timeout.setSingleShot(true);
+    connect(&m_timeout, &QTimer::timeout, this, [this]{
+        this->finish(false);
+    });
+}
+
+QPointer<StartupProfiler> StartupProfiler::m_instance(nullptr);
+
+StartupProfiler* StartupProfiler::instance()
+{
+    if (!m_instance) {
+        m_instance = new StartupProfiler(QCoreApplication::instance());
+    }
+
+    return m_instance;
+}
+
+void StartupProfiler::start(const QElapsedTimer &clock, const QString &reportPath)
+{
+    m_clock = clock;
+    m_reportPath = reportPath;
+    m_enabled = true;
+
+    qApp->installEventFilter(this);
+    connect(qApp, &QCoreApplication::aboutToQuit, this, [this]{
+        this->finish(false);
+    });
+    m_timeout.start(reportTimeout);
+}
+
+bool StartupProfiler::enabled() const
+{
+    return m_enabled && !m_finished;
+}
+
+bool StartupProfiler::complete() const
+{
+    return m_complete;
+}
+
+void StartupProfiler::setBenchmarkWallet(const QString &path)
+{
+    m_benchmarkWallet = path;
+}
+
+QString StartupProfiler::benchmarkWallet() const
+{
+    return m_benchmarkWallet;
+}
+
+void StartupProfiler::setFinalMilestone(Milestone milestone)
+{
+    m_finalMilestone = milestone;
+}
+
+qint64 StartupProfiler::elapsed() const
+{
+    return m_clock.elapsed();
+}
+
+void StartupProfiler::mark(Milestone milestone)
+{
+    if (!this->enabled() || m_milestones[milestone] >= 0) {
+        return;
+    }
+
+    m_milestones[milestone] = this->elapsed();
+    qDebug().noquote() << QString("Startup: %1 after %2 ms").arg(milestoneName(milestone), QString::number(m_milestones[milestone]));
+
+    if (milestone == m_finalMilestone) {
+        this->finish(true);
+    }
+}
+
+QString StartupProfiler::milestoneName(Milestone milestone)
+{
+    switch (milestone) {
+        case ApplicationReady:
+            return "application_ready";
+        case ConfigReady:
+            return "config_ready";
+        case WindowManagerReady:
+            return "window_manager_ready";
+        case FirstPaint:
+            return "first_paint";
+        case WalletOpenStarted:
+            return "wallet_open_started";
+        case WalletOpened:
+            return "wallet_opened";
+        case ModelsReady:
+            return "models_ready";
+        case FirstSyncTick:
+            return "first_sync_tick";
+        default:
+            return {};
+    }
+}
+
+bool StartupProfiler::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Paint && watched->isWidgetType() && static_cast<QWidget*>(watched)->isWindow()) {
+        this->mark(FirstPaint);
+        qApp->removeEventFilter(this);
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void StartupProfiler::finish(bool complete)
+{
+    if (!m_enabled || m_finished) {
+        return;
+    }
+    m_finished = true;
+    m_complete = complete;
+    m_timeout.stop();
+    qApp->removeEventFilter(this);
+
+    QJsonObject milestones;
+    for (int i = 0; i < COUNT; i++) {
+        auto milestone = static_cast<Milestone>(i);
+        milestones[milestoneName(milestone)] = m_milestones[i] < 0 ? QJsonValue() : QJsonValue(m_milestones[i]);
+    }
+
+    QJsonArray spans;
+    for (const auto &span : m_spans) {
+        spans.append(QJsonObject{{"name", span.name}, {"start", span.start}, {"duration", span.duration}});
+    }
+
+    QJsonObject report{
+        {"version", FEATHER_VERSION},
+        {"complete", complete},
+        {"benchmark", !m_benchmarkWallet.isEmpty()},
+        {"final_milestone", milestoneName(m_finalMilestone)},
+        {"milestones", milestones},
+        {"spans", spans}
+    };
+
+    QSaveFile file(m_reportPath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(report).toJson()) < 0 || !file.commit()) {
+        qWarning() << "Unable to write startup report:" << m_reportPath;
+    } else {
+        qInfo() << "Startup report written to" << m_reportPath;
+    }
+
+    emit finished();
+}
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#ifndef FEATHER_STARTUPPROFILER_H
+#define FEATHER_STARTUPPROFILER_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+// Records how long startup takes, from main() until the first sync status of the first wallet,
+// or until its models are ready in offline mode.
+//
+// Milestones are points on the critical path, spans time individual steps on it. Both are in
+// milliseconds since main() was entered. Nothing is recorded unless start() was called, the
+// report is written as JSON once the last milestone is reached, on timeout or on quit.
+class StartupProfiler : public QObject {
+    Q_OBJECT
+
+public:
+    enum Milestone {
+        ApplicationReady = 0, // QApplication constructed, command line parsed
+        ConfigReady,          // config, directories and logging set up
+        WindowManagerReady,   // wizard or wallet opening started
+        FirstPaint,           // first top level window painted
+        WalletOpenStarted,
+        WalletOpened,         // wallet window shown and interactive
+        ModelsReady,          // coins built, the balance is final
+        FirstSyncTick,        // first sync status from the node
+        COUNT
+    };
+
+    class Span {
+    public:
+        explicit Span(const char *name);
+        ~Span();
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+    private:
+        const char *m_name;
+        qint64 m_start = -1;
+    };
+
+    explicit StartupProfiler(QObject *parent);
+    static StartupProfiler* instance();
+
+    //! clock was started on entry to main()
+    void start(const QElapsedTimer &clock, const QString &reportPath);
+    [[nodiscard]] bool enabled() const;
+    //! the report was written after the final milestone, not on timeout or quit
+    [[nodiscard]] bool complete() const;
+
+    //! wallet to open instead of the wizard or the auto-open wallet, see --benchmark-startup
+    void setBenchmarkWallet(const QString &path);
+    [[nodiscard]] QString benchmarkWallet() const;
+
+    //! the report is written once this milestone is reached, FirstSyncTick by default
+    void setFinalMilestone(Milestone milestone);
+
+    //! only the first mark of each milestone counts
+    void mark(Milestone milestone);
+
+    static QString milestoneName(Milestone milestone);
+
+signals:
+    //! the report was written
+    void finished();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    struct SpanRecord {
+        QString name;
+        qint64 start;
+        qint64 duration;
+    };
+
+    void finish(bool complete);
+    qint64 elapsed() const;
+
+    QElapsedTimer m_clock;
+    QString m_reportPath;
+    QString m_benchmarkWallet;
+    bool m_enabled = false;
+    bool m_finished = false;
+    bool m_complete = false;
+    Milestone m_finalMilestone = FirstSyncTick;
+
+    qint64 m_milestones[COUNT];
+    QList<SpanRecord> m_spans;
+    QTimer m_timeout;
+
+    static QPointer<StartupProfiler> m_instance;
+};
+
+inline StartupProfiler* startupProfiler()
+{
+    return StartupProfiler::instance();
+}
+
+#endif //FEATHER_STARTUPPROFILER_H
@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#ifndef FEATHER_TRIGRAMINDEX_H
+#define FEATHER_TRIGRAMINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+
+#include <algorithm>
+#include <optional>
+
+// Case-insensitive substring index. Every text is split into overlapping three character
+// sequences, a query only has to intersect the ids of the trigrams it consists of.
+//
+// Results are candidates: every id whose text contains the query is returned, but a few
+// that don't may be returned as well. Callers verify candidates against the actual text.
+template <typename Id>
+class TrigramIndex
+{
+public:
+    void insert(Id id, const QString &text) {
+        for (quint64 trigram : trigrams(text)) {
+            QList<Id> &ids = m_postings[trigram];
+            // Ids are mostly inserted in ascending order, keep the list sorted for intersect()
+            auto it = std::lower_bound(ids.begin(), ids.end(), id);
+            if (it == ids.end() || *it != id) {
+                ids.insert(it, id);
+            }
+        }
+    }
+
+    // text must be what id was inserted with
+    void remove(Id id, const QString &text) {
+        for (quint64 trigram : trigrams(text)) {
+            auto posting = m_postings.find(trigram);
+            if (posting == m_postings.end()) {
+                continue;
+            }
+            QList<Id> &ids = posting.value();
+            auto it = std::lower_bound(ids.begin(), ids.end(), id);
+            if (it != ids.end() && *it == id) {
+                ids.erase(it);
+            }
+            if (ids.isEmpty()) {
+                m_postings.erase(posting);
+            }
+        }
+    }
+
+    void clear() {
+        m_postings.clear();
+    }
+
+    // Ids whose text may contain query, std::nullopt if the query is too short to use the index
+    std::optional<QSet<Id>> candidates(const QString &query) const {
+        QSet<quint64> keys = trigrams(query);
+        if (keys.isEmpty()) {
+            return std::nullopt;
+        }
+
+        // Start with the rarest trigram, the result can only get smaller
+        QList<const QList<Id>*> lists;
+        for (quint64 trigram : keys) {
+            auto posting = m_postings.constFind(trigram);
+            if (posting == m_postings.constEnd()) {
+                return QSet<Id>{};
+            }
+            lists.append(&posting.value());
+        }
+        std::sort(lists.begin(), lists.end(), [](const QList<Id> *a, const QList<Id> *b) {
+            return a->size() < b->size();
+        });
+
+        QList<Id> result = *lists.first();
+        for (qsizetype i = 1; i < lists.size() && !result.isEmpty(); ++i) {
+            QList<Id> intersection;
+            std::set_intersection(result.cbegin(), result.cend(), lists[i]->cbegin(), lists[i]->cend(),
+                                  std::back_inserter(intersection));
+            result = std::move(intersection);
+        }
+
+        return QSet<Id>(result.cbegin(), result.cend());
+    }
+
+    static bool isPlain(const QString &query) {
+        // Anything that could be a regular expression goes through the caller's slow path
+        static const QString special = QStringLiteral("\\^$.|?*+()[]{}");
+        return std::none_of(query.cbegin(), query.cend(), [](QChar c) {
+            return special.contains(c);
+        });
+    }
+
+private:
+    static QSet<quint64> trigrams(const QString &text) {
+        QSet<quint64> result;
+        QString folded = text.toCaseFolded();
+        for (qsizetype i = 0; i + 3 <= folded.size(); ++i) {
+            result.insert((quint64(folded[i].unicode()) << 32) | (quint64(folded[i + 1].unicode()) << 16) | folded[i + 2].unicode());
+        }
+        return result;
+    }
+
+    QHash<quint64, QList<Id>> m_postings;
+};
+
+#endif //FEATHER_TRIGRAMINDEX_H
@@ -165,6 +165,10 @@ bool portableFileExists(const QString &dir) {
 }
 
 QString defaultWalletDir() {
+    if (Config::hasCustomConfigDir()) {
+        return Config::defaultConfigDir().filePath("wallets");
+    }
+
     if (Utils::isPortableMode()) {
         return Utils::portablePath() + "/wallets";
     }
@@ -209,12 +213,13 @@ QString defaultWalletDir() {
 }
 
 QString ringDatabasePath() {
-    if (Utils::isPortableMode()) {
+    if (Config::hasCustomConfigDir() || Utils::isPortableMode()) {
         QString suffix = "";
         if (constants::networkType != NetworkType::Type::MAINNET) {
             suffix = "-" + Utils::QtEnumToString(constants::networkType);
         }
-        return Utils::portablePath() + "/ringdb" + suffix;
+        QString dataDir = Config::hasCustomConfigDir() ? Config::defaultConfigDir().path() : Utils::portablePath();
+        return dataDir + "/ringdb" + suffix;
     }
     return ""; // Use libwallet default
 }
@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include "ZmqNotifier.h"
+
+#include <QDebug>
+#include <QThread>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#ifdef WITH_ZMQ
+#include <cstring>
+#include <zmq.h>
+#endif
+
+namespace {
+    const char *chainMainTopic = "json-minimal-chain_main";
+    const char *txPoolAddTopic = "json-minimal-txpool_add";
+
+    // Blocks arrive every two minutes on average, a silent publisher is considered gone after this
+    constexpr qint64 silenceTimeoutMs = 10 * 60 * 1000;
+
+    // Pool transactions can arrive in bursts, one refresh per interval is enough
+    constexpr qint64 txPoolIntervalMs = 2000;
+}
+
+ZmqNotifier::ZmqNotifier(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ZmqNotifier::~ZmqNotifier() {
+    this->stop();
+
+    // The threads call into this object until they return
+    for (QThread *thread : std::as_const(m_threads)) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+bool ZmqNotifier::isSupported() {
+#ifdef WITH_ZMQ
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ZmqNotifier::subscribe(const QString &endpoint, const QString &proxyAddress) {
+    this->stop();
+
+    if (!isSupported() || endpoint.isEmpty()) {
+        return;
+    }
+
+    auto subscription = std::make_shared<Subscription>();
+    subscription->endpoint = endpoint;
+    subscription->proxyAddress = proxyAddress;
+    m_subscription = subscription;
+
+    QThread *thread = QThread::create([this, subscription] {
+        this->run(*subscription);
+    });
+    connect(thread, &QThread::finished, this, [this, thread] {
+        m_threads.removeOne(thread);
+        thread->deleteLater();
+    });
+    m_threads.append(thread);
+    thread->start();
+}
+
+void ZmqNotifier::stop() {
+    if (!m_subscription) {
+        return;
+    }
+
+    // The thread notices within the receive timeout, nothing it reports from now on is used
+    m_subscription->cancelled = true;
+    m_subscription.reset();
+
+    if (m_active.exchange(false)) {
+        emit activeChanged(false);
+    }
+}
+
+bool ZmqNotifier::isActive() const {
+    return m_active;
+}
+
+void ZmqNotifier::setActive(const Subscription &subscription, bool active) {
+    if (subscription.cancelled) {
+        return;
+    }
+
+    // Checked again where stop() runs, it may cancel the subscription between here and there
+    QMetaObject::invokeMethod(this, [this, weak = subscription.weak_from_this(), active] {
+        // A newer subscription owns the state now
+        std::shared_ptr<const Subscription> current = weak.lock();
+        if (!current || current != m_subscription || current->cancelled) {
+            return;
+        }
+        if (m_active.exchange(active) != active) {
+            emit activeChanged(active);
+        }
+    }, Qt::QueuedConnection);
+}
+
+void ZmqNotifier::run(Subscription &subscription) {
+#ifdef WITH_ZMQ
+    const QString &endpoint = subscription.endpoint;
+    const QString &proxyAddress = subscription.proxyAddress;
+
+    void *context = zmq_ctx_new();
+    void *socket = zmq_socket(context, ZMQ_SUB);
+
+    int timeout = 500; // ms, bounds how long the thread outlives stop()
+    int linger = 0;
+    zmq_setsockopt(socket, ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+    zmq_setsockopt(socket, ZMQ_LINGER, &linger, sizeof(linger));
+    zmq_setsockopt(socket, ZMQ_SUBSCRIBE, chainMainTopic, strlen(chainMainTopic));
+    zmq_setsockopt(socket, ZMQ_SUBSCRIBE, txPoolAddTopic, strlen(txPoolAddTopic));
+
+    if (!proxyAddress.isEmpty()) {
+        QByteArray proxy = proxyAddress.toUtf8();
+        zmq_setsockopt(socket, ZMQ_SOCKS_PROXY, proxy.constData(), proxy.size());
+    }
+
+    bool running = true;
+    if (zmq_connect(socket, endpoint.toUtf8().constData()) != 0) {
+        qWarning() << "ZMQ: unable to connect to" << endpoint << ":" << zmq_strerror(zmq_errno());
+        running = false;
+    } else {
+        qDebug() << "ZMQ: subscribed to" << endpoint;
+    }
+
+    QElapsedTimer lastMessage;
+    lastMessage.start();
+    subscription.lastTxPoolAdd.invalidate();
+
+    while (running && !subscription.cancelled) {
+        zmq_msg_t msg;
+        zmq_msg_init(&msg);
+        int size = zmq_msg_recv(&msg, socket, 0);
+
+        if (size >= 0) {
+            lastMessage.restart();
+            this->handleMessage(subscription, QByteArray(static_cast<const char*>(zmq_msg_data(&msg)), size));
+        }
+        else if (zmq_errno() != EAGAIN) {
+            qWarning() << "ZMQ: receive failed:" << zmq_strerror(zmq_errno());
+            running = false;
+        }
+        else if (lastMessage.hasExpired(silenceTimeoutMs)) {
+            this->setActive(subscription, false);
+        }
+
+        zmq_msg_close(&msg);
+    }
+
+    zmq_close(socket);
+    zmq_ctx_term(context);
+#endif
+
+    this->setActive(subscription, false);
+}
+
+void ZmqNotifier::handleMessage(Subscription &subscription, const QByteArray &message) {
+    // Messages are framed as "<topic>:<json>"
+    qsizetype sep = message.indexOf(':');
+    if (sep < 0) {
+        return;
+    }
+
+    QByteArray topic = message.left(sep);
+    QJsonDocument doc = QJsonDocument::fromJson(message.mid(sep + 1));
+
+    if (topic == chainMainTopic) {
+        QJsonObject obj = doc.object();
+        qint64 count = obj.value("ids").toArray().size();
+        if (count == 0) {
+            return;
+        }
+
+        if (subscription.cancelled) {
+            return;
+        }
+        this->setActive(subscription, true);
+        quint64 height = obj.value("first_height").toInteger() + count - 1;
+        emit chainMain(height);
+    }
+    else if (topic == txPoolAddTopic) {
+        if (subscription.cancelled) {
+            return;
+        }
+        this->setActive(subscription, true);
+        if (!subscription.lastTxPoolAdd.isValid() || subscription.lastTxPoolAdd.hasExpired(txPoolIntervalMs)) {
+            subscription.lastTxPoolAdd.start();
+            emit txPoolAdd();
+        }
+    }
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#ifndef FEATHER_ZMQNOTIFIER_H
+#define FEATHER_ZMQNOTIFIER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+
+class QThread;
+
+// Subscribes to the ZMQ publisher of a node (monerod --zmq-pub) and reports new blocks
+// and pool transactions. Connection problems are not fatal: the wallet keeps polling.
+//
+// Every subscription runs on a thread of its own. Switching nodes doesn't wait for the previous
+// thread, it finishes in the background within the receive timeout and can't report anything after.
+class ZmqNotifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ZmqNotifier(QObject *parent = nullptr);
+    //! waits for the threads of previous subscriptions
+    ~ZmqNotifier() override;
+
+    //! false if Feather was built without ZMQ support
+    static bool isSupported();
+
+    //! (re)subscribe to endpoint (e.g. tcp://127.0.0.1:18083), optionally through a SOCKS5 proxy (host:port)
+    void subscribe(const QString &endpoint, const QString &proxyAddress = "");
+
+    //! unsubscribe, returns right away
+    void stop();
+
+    //! true while notifications are arriving
+    bool isActive() const;
+
+signals:
+    void chainMain(quint64 height);
+    void txPoolAdd();
+    void activeChanged(bool active);
+
+private:
+    // State of one subscription, shared with its thread
+    struct Subscription : std::enable_shared_from_this<Subscription> {
+        QString endpoint;
+        QString proxyAddress;
+        std::atomic<bool> cancelled{false};
+        QElapsedTimer lastTxPoolAdd; // subscription thread only
+    };
+
+    void run(Subscription &subscription);
+    void handleMessage(Subscription &subscription, const QByteArray &message);
+    //! called on the subscription thread, applied on the GUI thread if subscription is still current
+    void setActive(const Subscription &subscription, bool active);
+
+    std::atomic<bool> m_active{false}; // written on the GUI thread only
+
+    std::shared_ptr<Subscription> m_subscription; // GUI thread only
+    QList<QThread*> m_threads;                    // not finished yet
+};
+
+#endif //FEATHER_ZMQNOTIFIER_H
@@ -52,6 +52,7 @@ static const QHash<Config::ConfigKey, ConfigDirective> configStrings = {
 
         // History
         {Config::historyShowFullTxid, {QS("historyShowFullTxid"), false}},
+        {Config::modelRefreshBudget, {QS("modelRefreshBudget"), 250}},
 
         // Receive
         {Config::showUsedAddresses,{QS("showUsedAddresses"), false}},
@@ -132,6 +133,7 @@ static const QHash<Config::ConfigKey, ConfigDirective> configStrings = {
 
 
 QPointer<Config> Config::m_instance(nullptr);
+QString Config::m_customConfigDir;
 
 QVariant Config::get(ConfigKey key)
 {
@@ -205,6 +207,10 @@ Config::Config(QObject* parent)
 }
 
 QDir Config::defaultConfigDir() {
+    if (!m_customConfigDir.isEmpty()) {
+        return QDir(m_customConfigDir);
+    }
+
     if (Utils::isPortableMode()) {
         return Utils::portablePath();
     }
@@ -246,6 +252,14 @@ QDir Config::defaultConfigDir() {
 #endif
 }
 
+void Config::setConfigDir(const QString &path) {
+    m_customConfigDir = QDir(path).absolutePath();
+}
+
+bool Config::hasCustomConfigDir() {
+    return !m_customConfigDir.isEmpty();
+}
+
 Config::~Config()
 {
 }
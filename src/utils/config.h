@@ -51,6 +51,7 @@ public:
 
         // History
         historyShowFullTxid,
+        modelRefreshBudget, // Minimum interval in ms between model refreshes while blocks come in
 
         // Receive
         showUsedAddresses,
@@ -179,6 +180,9 @@ public:
     void resetToDefaults();
 
     static QDir defaultConfigDir();
+    //! used instead of the default config dir, see --config-dir. Must be set before the config is first used.
+    static void setConfigDir(const QString &path);
+    static bool hasCustomConfigDir();
 
     static Config* instance();
 
@@ -191,6 +195,7 @@ private:
     void init(const QString& configFileName);
 
     static QPointer<Config> m_instance;
+    static QString m_customConfigDir;
 
     QScopedPointer<QSettings> m_settings;
     QHash<QString, QVariant> m_defaults;
@@ -11,6 +11,7 @@
 #include "constants.h"
 #include "utils/WebsocketNotifier.h"
 #include "utils/TorManager.h"
+#include "utils/ZmqNotifier.h"
 
 bool NodeList::addNode(const QString &node, NetworkType::Type networkType, NodeList::Type source) {
     // We can't obtain references to QJsonObjects...
@@ -101,6 +102,7 @@ Nodes::Nodes(QObject *parent, Wallet *wallet)
     , modelCustom(new NodeModel(NodeSource::custom, this))
     , m_connection(FeatherNode())
     , m_wallet(wallet)
+    , m_zmqNotifier(new ZmqNotifier(this))
 {
     // TODO: This class is in desperate need of refactoring
 
@@ -109,6 +111,10 @@ Nodes::Nodes(QObject *parent, Wallet *wallet)
 
     if (m_wallet) {
         connect(m_wallet, &Wallet::walletRefreshed, this, &Nodes::onWalletRefreshed);
+
+        connect(m_zmqNotifier, &ZmqNotifier::chainMain, m_wallet, &Wallet::requestRefresh);
+        connect(m_zmqNotifier, &ZmqNotifier::txPoolAdd, m_wallet, &Wallet::requestRefresh);
+        connect(m_zmqNotifier, &ZmqNotifier::activeChanged, m_wallet, &Wallet::setBlockNotificationsActive);
     }
 }
 
@@ -240,6 +246,13 @@ void Nodes::connectToNode(const FeatherNode &node) {
 
     m_wallet->initAsync(node.toAddress(), true, 0, proxyAddress);
 
+    // Block notifications are an optimization, polling continues if the publisher is unreachable
+    if (!node.zmq.isEmpty() && ZmqNotifier::isSupported()) {
+        m_zmqNotifier->subscribe(node.zmq, proxyAddress);
+    } else {
+        m_zmqNotifier->stop();
+    }
+
     m_connection = node;
     m_connection.isActive = false;
     m_connection.isConnecting = true;
@@ -609,4 +622,6 @@ void Nodes::allowConnection() {
     m_allowConnection = true;
 }
 
-Nodes::~Nodes() = default;
+Nodes::~Nodes() {
+    m_zmqNotifier->stop();
+}
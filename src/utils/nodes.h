@@ -16,6 +16,7 @@
 #include "utils/config.h"
 
 class Wallet;
+class ZmqNotifier;
 
 enum NodeSource {
     websocket = 0,
@@ -50,6 +51,17 @@ struct FeatherNode {
         if (address.isEmpty())
             return;
 
+        // Optional settings may follow the address, e.g: "127.0.0.1:18081 zmq=tcp://127.0.0.1:18083"
+        QStringList parts = address.split(' ', Qt::SkipEmptyParts);
+        if (parts.isEmpty())
+            return;
+
+        address = parts.takeFirst();
+        for (const auto &part : parts) {
+            if (part.startsWith("zmq="))
+                zmq = part.mid(4);
+        }
+
         address.remove("https://"); // todo: regex
         if (!address.startsWith("http://"))
             address.prepend("http://");
@@ -71,6 +83,7 @@ struct FeatherNode {
     bool isConnecting = false;
     bool isActive = false;
     QUrl url;
+    QString zmq;  // ZMQ publisher endpoint for block notifications, if any
 
     bool isValid() const {
         return url.isValid();
@@ -125,10 +138,14 @@ struct FeatherNode {
     }
 
     QString toFullAddress() const {
+        QString address = toAddress();
         if (!url.userName().isEmpty() && !url.password().isEmpty())
-            return QString("%1:%2@%3:%4").arg(url.userName(), url.password(), url.host(), QString::number(url.port()));
+            address = QString("%1:%2@%3:%4").arg(url.userName(), url.password(), url.host(), QString::number(url.port()));
+
+        if (!zmq.isEmpty())
+            address += QString(" zmq=%1").arg(zmq);
 
-        return toAddress();
+        return address;
     }
 
     QString toURL() const {
@@ -177,6 +194,7 @@ private slots:
 
 private:
     Wallet *m_wallet = nullptr;
+    ZmqNotifier *m_zmqNotifier = nullptr;
     QJsonObject m_configJson;
 
     NodeList m_nodes;
@@ -3,8 +3,8 @@
 
 #include "scheduler.h"
 
-FutureScheduler::FutureScheduler(QObject *parent)
-    : QObject(parent), Alive(0), Stopping(false)
+FutureScheduler::FutureScheduler(QObject *parent, QThreadPool *pool)
+    : QObject(parent), Alive(0), Stopping(false), Pool(pool ? pool : QThreadPool::globalInstance())
 {
 }
 
@@ -28,7 +28,7 @@ void FutureScheduler::shutdownWaitForFinished() noexcept
 QPair<bool, QFuture<void>> FutureScheduler::run(std::function<void()> function) noexcept
 {
     return execute<void>([this, function](QFutureWatcher<void> *) {
-        return QtConcurrent::run([this, function] {
+        return QtConcurrent::run(Pool, [this, function] {
             try
             {
                 function();
@@ -48,7 +48,7 @@ QPair<bool, QFuture<QVariantMap>> FutureScheduler::run(const std::function<QVari
         connect(watcher, &QFutureWatcher<QVariantMap>::finished, [watcher, callback] {
             callback(watcher->future().result());
         });
-        return QtConcurrent::run([this, function] {
+        return QtConcurrent::run(Pool, [this, function] {
             QVariantMap result;
             try
             {
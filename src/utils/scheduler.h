@@ -8,6 +8,7 @@
 #include <QFuture>
 #include <QMutex>
 #include <QPair>
+#include <QThreadPool>
 #include <QWaitCondition>
 
 class FutureScheduler : public QObject
@@ -15,7 +16,8 @@ class FutureScheduler : public QObject
     Q_OBJECT
 
 public:
-    FutureScheduler(QObject *parent);
+    //! runs on the global thread pool unless another pool is given, pool must outlive the scheduler
+    FutureScheduler(QObject *parent, QThreadPool *pool = nullptr);
     ~FutureScheduler();
 
     void shutdownWaitForFinished() noexcept;
@@ -62,6 +64,7 @@ private:
     QWaitCondition Condition;
     QMutex Mutex;
     std::atomic<bool> Stopping;
+    QThreadPool *Pool;
 };
 
 #endif // FUTURE_SCHEDULER_H
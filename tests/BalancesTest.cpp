@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include <QtTest>
+
+#include "libwalletqt/Balances.h"
+
+namespace {
+    CoinsInfo coin(quint32 account, quint32 subaddress, quint64 amount, quint64 unlockHeight) {
+        CoinsInfo c;
+        c.subaddrAccount = account;
+        c.subaddrIndex = subaddress;
+        c.amount = amount;
+        c.unlockHeight = unlockHeight;
+        c.keyImageKnown = true;
+        return c;
+    }
+
+    quint64 subaddressKey(quint32 account, quint32 subaddress) {
+        return (quint64(account) << 32) | subaddress;
+    }
+}
+
+class BalancesTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void aggregate();
+    void ignoreSpentAndFrozen();
+    void unlockByHeight();
+    void pendingChange();
+    void remove();
+    void generation();
+};
+
+void BalancesTest::aggregate()
+{
+    Balances balances;
+    balances.clear(100);
+    balances.add(coin(0, 0, 5, 90));
+    balances.add(coin(0, 1, 3, 90));
+    balances.add(coin(1, 0, 7, 90));
+
+    QCOMPARE(balances.total(0), quint64(8));
+    QCOMPARE(balances.unlocked(0), quint64(8));
+    QCOMPARE(balances.total(0, 0), quint64(5));
+    QCOMPARE(balances.total(0, 1), quint64(3));
+    QCOMPARE(balances.total(1), quint64(7));
+    QCOMPARE(balances.totalAll(), quint64(15));
+    QCOMPARE(balances.unlockedAll(), quint64(15));
+
+    // Accounts and subaddresses nobody received anything on
+    QCOMPARE(balances.total(2), quint64(0));
+    QCOMPARE(balances.unlocked(2), quint64(0));
+    QCOMPARE(balances.total(0, 5), quint64(0));
+    QCOMPARE(balances.unlocked(0, 5), quint64(0));
+}
+
+void BalancesTest::ignoreSpentAndFrozen()
+{
+    Balances balances;
+    balances.clear(100);
+
+    CoinsInfo spent = coin(0, 0, 5, 90);
+    spent.spent = true;
+    CoinsInfo frozen = coin(0, 0, 3, 90);
+    frozen.frozen = true;
+
+    balances.add(spent);
+    balances.add(frozen);
+    balances.add(coin(0, 0, 1, 90));
+
+    QCOMPARE(balances.total(0), quint64(1));
+    QCOMPARE(balances.unlocked(0), quint64(1));
+    QCOMPARE(balances.totalAll(), quint64(1));
+}
+
+void BalancesTest::unlockByHeight()
+{
+    Balances balances;
+    balances.clear(100);
+    balances.add(coin(0, 0, 5, 90));
+    balances.add(coin(0, 1, 3, 105));
+    balances.add(coin(1, 0, 7, 110));
+
+    QCOMPARE(balances.total(0), quint64(8));
+    QCOMPARE(balances.unlocked(0), quint64(5));
+    QCOMPARE(balances.unlocked(0, 1), quint64(0));
+    QCOMPARE(balances.unlocked(1), quint64(0));
+    QCOMPARE(balances.unlockedAll(), quint64(5));
+
+    balances.setHeight(105);
+    QCOMPARE(balances.unlocked(0), quint64(8));
+    QCOMPARE(balances.unlocked(0, 1), quint64(3));
+    QCOMPARE(balances.unlocked(1), quint64(0));
+    QCOMPARE(balances.unlockedAll(), quint64(8));
+
+    // The height never goes back without a clear()
+    balances.setHeight(95);
+    QCOMPARE(balances.unlocked(0, 1), quint64(3));
+
+    balances.setHeight(200);
+    QCOMPARE(balances.unlocked(1), quint64(7));
+    QCOMPARE(balances.unlockedAll(), quint64(15));
+    QCOMPARE(balances.totalAll(), quint64(15));
+}
+
+void BalancesTest::pendingChange()
+{
+    Balances balances;
+    balances.clear(100);
+    balances.add(coin(0, 0, 5, 90));
+    balances.add(coin(0, 1, 3, 110));
+
+    // Change of an outgoing transaction in the pool and an incoming one on another account
+    balances.setPending({{subaddressKey(0, 0), 4}, {subaddressKey(1, 2), 6}});
+
+    QCOMPARE(balances.total(0), quint64(12));
+    QCOMPARE(balances.unlocked(0), quint64(5));
+    QCOMPARE(balances.total(0, 0), quint64(9));
+    QCOMPARE(balances.unlocked(0, 0), quint64(5));
+    QCOMPARE(balances.total(1), quint64(6));
+    QCOMPARE(balances.unlocked(1), quint64(0));
+    QCOMPARE(balances.total(1, 2), quint64(6));
+    QCOMPARE(balances.unlocked(1, 2), quint64(0));
+    QCOMPARE(balances.totalAll(), quint64(18));
+    QCOMPARE(balances.unlockedAll(), quint64(5));
+
+    // Pending amounts are never unlocked
+    balances.setHeight(200);
+    QCOMPARE(balances.unlocked(0), quint64(8));
+    QCOMPARE(balances.unlockedAll(), quint64(8));
+    QCOMPARE(balances.totalAll(), quint64(18));
+
+    // Once mined the change is a coin, the pending amount goes away
+    balances.setPending({{subaddressKey(1, 2), 6}});
+    balances.add(coin(0, 0, 4, 210));
+    QCOMPARE(balances.total(0), quint64(12));
+    QCOMPARE(balances.unlocked(0), quint64(8));
+    QCOMPARE(balances.totalAll(), quint64(18));
+
+    balances.setPending({});
+    QCOMPARE(balances.total(1), quint64(0));
+    QCOMPARE(balances.totalAll(), quint64(12));
+}
+
+void BalancesTest::remove()
+{
+    Balances balances;
+    balances.clear(100);
+    CoinsInfo unlocked = coin(0, 0, 5, 90);
+    CoinsInfo locked = coin(0, 1, 3, 110);
+    balances.add(unlocked);
+    balances.add(locked);
+
+    balances.remove(locked);
+    QCOMPARE(balances.total(0), quint64(5));
+    QCOMPARE(balances.unlocked(0), quint64(5));
+    QCOMPARE(balances.total(0, 1), quint64(0));
+
+    // Nothing left to unlock
+    balances.setHeight(200);
+    QCOMPARE(balances.unlocked(0), quint64(5));
+
+    balances.remove(unlocked);
+    QCOMPARE(balances.totalAll(), quint64(0));
+    QCOMPARE(balances.unlockedAll(), quint64(0));
+}
+
+void BalancesTest::generation()
+{
+    Balances balances;
+    balances.clear(100);
+    quint64 generation = balances.generation();
+
+    balances.add(coin(0, 0, 5, 110));
+    QVERIFY(balances.generation() > generation);
+    generation = balances.generation();
+
+    CoinsInfo spent = coin(0, 0, 5, 90);
+    spent.spent = true;
+    balances.add(spent);
+    QCOMPARE(balances.generation(), generation);
+
+    balances.setPending({{subaddressKey(0, 0), 1}});
+    QVERIFY(balances.generation() > generation);
+    generation = balances.generation();
+
+    balances.setPending({{subaddressKey(0, 0), 1}});
+    QCOMPARE(balances.generation(), generation);
+
+    // Nothing unlocks before 110
+    balances.setHeight(105);
+    QCOMPARE(balances.generation(), generation);
+
+    balances.setHeight(110);
+    QVERIFY(balances.generation() > generation);
+    generation = balances.generation();
+
+    balances.clear(0);
+    QVERIFY(balances.generation() > generation);
+    QCOMPARE(balances.totalAll(), quint64(0));
+}
+
+QTEST_GUILESS_MAIN(BalancesTest)
+#include "BalancesTest.moc"
@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include <QtTest>
+
+#include "libwalletqt/CoinSelector.h"
+
+namespace {
+    QList<CoinsInfo> makeCoins(const QList<quint64> &amounts) {
+        QList<CoinsInfo> coins;
+        for (quint64 amount : amounts) {
+            CoinsInfo coin;
+            coin.amount = amount;
+            coin.keyImageKnown = true;
+            coins.append(coin);
+        }
+        return coins;
+    }
+
+    QList<qsizetype> select(const QList<CoinsInfo> &coins, CoinSelector::Strategy strategy, quint64 target,
+                            quint64 feePerInput = 0) {
+        CoinSelector::Params params;
+        params.strategy = strategy;
+        params.target = target;
+        params.feePerInput = feePerInput;
+        params.walletHeight = 1000;
+
+        QList<qsizetype> result = CoinSelector::select(coins, params);
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+}
+
+class CoinSelectorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void exactMatchBacktracks();
+    void exactMatchWithFees();
+    void leastChange();
+    void leastChangePrefersSingleCoin();
+    void minimizeInputs();
+    void consolidateDust();
+    void spendByAge();
+    void skipIneligible();
+    void uncoverable();
+};
+
+void CoinSelectorTest::exactMatchBacktracks()
+{
+    // Largest first overshoots with 6 and 5, only 4 + 3 hits 7 exactly
+    QList<CoinsInfo> coins = makeCoins({3, 6, 4, 5});
+    QCOMPARE(select(coins, CoinSelector::MinimizeChange, 7), (QList<qsizetype>{0, 2}));
+
+    // Including the second 3 after excluding the first is skipped, both are still found together
+    coins = makeCoins({5, 3, 5, 3});
+    QCOMPARE(select(coins, CoinSelector::MinimizeChange, 6), (QList<qsizetype>{1, 3}));
+}
+
+void CoinSelectorTest::exactMatchWithFees()
+{
+    // Coins are weighed by what they are worth after paying for themselves, 10 never is
+    QList<CoinsInfo> coins = makeCoins({10, 60, 110, 50});
+    QCOMPARE(select(coins, CoinSelector::MinimizeChange, 100, 10), QList<qsizetype>{2});
+    QCOMPARE(select(coins, CoinSelector::MinimizeChange, 90, 10), (QList<qsizetype>{1, 3}));
+}
+
+void CoinSelectorTest::leastChange()
+{
+    // Nothing adds up to 8: 6 + 3 leaves less change than 10 alone
+    QList<CoinsInfo> coins = makeCoins({10, 6, 3});
+    QCOMPARE(select(coins, CoinSelector::MinimizeChange, 8), (QList<qsizetype>{1, 2}));
+}
+
+void CoinSelectorTest::leastChangePrefersSingleCoin()
+{
+    // 6 + 3 and 9 leave the same change, one input is cheaper
+    QList<CoinsInfo> coins = makeCoins({9, 6, 3});
+    QCOMPARE(select(coins, CoinSelector::MinimizeChange, 8), QList<qsizetype>{0});
+
+    // Nothing below the target to combine
+    coins = makeCoins({20, 12});
+    QCOMPARE(select(coins, CoinSelector::MinimizeChange, 8), QList<qsizetype>{1});
+}
+
+void CoinSelectorTest::minimizeInputs()
+{
+    QList<CoinsInfo> coins = makeCoins({10, 7, 2});
+
+    // The largest coin covers 8 on its own
+    QCOMPARE(select(coins, CoinSelector::MinimizeInputs, 8), QList<qsizetype>{0});
+    // The last coin is swapped for the smallest that still covers the target
+    QCOMPARE(select(coins, CoinSelector::MinimizeInputs, 6), QList<qsizetype>{1});
+    QCOMPARE(select(coins, CoinSelector::MinimizeInputs, 12), (QList<qsizetype>{0, 2}));
+    QCOMPARE(select(coins, CoinSelector::MinimizeInputs, 19), (QList<qsizetype>{0, 1, 2}));
+}
+
+void CoinSelectorTest::consolidateDust()
+{
+    QList<CoinsInfo> coins = makeCoins({100, 3, 1, 2});
+
+    CoinSelector::Params params;
+    params.strategy = CoinSelector::ConsolidateDust;
+    params.walletHeight = 1000;
+    params.maxInputs = 3;
+    QList<qsizetype> result = CoinSelector::select(coins, params);
+    std::sort(result.begin(), result.end());
+    QCOMPARE(result, (QList<qsizetype>{1, 2, 3}));
+
+    // With a target, smallest first until it is covered
+    QCOMPARE(select(coins, CoinSelector::ConsolidateDust, 3), (QList<qsizetype>{2, 3}));
+
+    // Consolidating a single coin only costs a fee
+    QVERIFY(CoinSelector::select(makeCoins({5}), params).isEmpty());
+}
+
+void CoinSelectorTest::spendByAge()
+{
+    QList<CoinsInfo> coins = makeCoins({10, 10, 5});
+    coins[0].blockHeight = 100;
+    coins[1].blockHeight = 990;
+    coins[2].blockHeight = 120;
+
+    // The two old coins cover it, the recent one is left alone
+    QCOMPARE(select(coins, CoinSelector::PrivacyAge, 12), (QList<qsizetype>{0, 2}));
+
+    // Too much for the old coins alone, the next bucket is added
+    QCOMPARE(select(coins, CoinSelector::PrivacyAge, 20), (QList<qsizetype>{0, 1}));
+}
+
+void CoinSelectorTest::skipIneligible()
+{
+    QList<CoinsInfo> coins = makeCoins({50, 50, 50, 50, 50, 1, 7});
+    coins[0].spent = true;
+    coins[1].frozen = true;
+    coins[2].keyImageKnown = false;
+    coins[3].unlockHeight = 1010;
+
+    for (int strategy = 0; strategy < CoinSelector::COUNT; ++strategy) {
+        auto result = select(coins, CoinSelector::Strategy(strategy), 49, 1);
+        QVERIFY(!result.isEmpty());
+        for (qsizetype index : result) {
+            QVERIFY(index == 4 || index == 6);
+        }
+    }
+
+    // 1 is worth less than it costs to spend, 49 + 6 is all there is
+    QVERIFY(select(coins, CoinSelector::MinimizeInputs, 56, 1).isEmpty());
+    QCOMPARE(select(coins, CoinSelector::MinimizeInputs, 55, 1), (QList<qsizetype>{4, 6}));
+}
+
+void CoinSelectorTest::uncoverable()
+{
+    QList<CoinsInfo> coins = makeCoins({5, 3});
+    for (int strategy = 0; strategy < CoinSelector::COUNT; ++strategy) {
+        QVERIFY(select(coins, CoinSelector::Strategy(strategy), 9).isEmpty());
+    }
+
+    QVERIFY(select(coins, CoinSelector::MinimizeInputs, 0).isEmpty());
+    QVERIFY(select({}, CoinSelector::MinimizeChange, 1).isEmpty());
+}
+
+QTEST_GUILESS_MAIN(CoinSelectorTest)
+#include "CoinSelectorTest.moc"
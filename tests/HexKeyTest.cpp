@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include <QtTest>
+
+#include "libwalletqt/rows/HexKey.h"
+
+namespace {
+    const QString txid = "beb76a82ea17400cd6d7f595f70e1667d2018ed8f5a78d1ce07484222618c3cd";
+}
+
+class HexKeyTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip();
+    void upperCase();
+    void invalid_data();
+    void invalid();
+    void null();
+    void fromPod();
+    void hash();
+};
+
+void HexKeyTest::roundTrip()
+{
+    bool ok = false;
+    HexKey key = HexKey::fromHex(txid, &ok);
+    QVERIFY(ok);
+    QVERIFY(!key.isNull());
+    QCOMPARE(key.bytes[0], uchar(0xbe));
+    QCOMPARE(key.bytes[31], uchar(0xcd));
+    QCOMPARE(key.toHex(), txid);
+
+    // Cached or not, the same string
+    QCOMPARE(key.toString(), txid);
+    QCOMPARE(key.toString(), txid);
+}
+
+void HexKeyTest::upperCase()
+{
+    bool ok = false;
+    HexKey key = HexKey::fromHex(txid.toUpper(), &ok);
+    QVERIFY(ok);
+    QCOMPARE(key.toHex(), txid);
+    QVERIFY(key == HexKey::fromHex(txid));
+}
+
+void HexKeyTest::invalid_data()
+{
+    QTest::addColumn<QString>("hex");
+
+    QTest::newRow("empty") << QString();
+    QTest::newRow("too short") << txid.left(62);
+    QTest::newRow("too long") << txid + "00";
+    QTest::newRow("odd length") << txid.left(63);
+    QTest::newRow("non-hex") << QString(64, 'z');
+    QTest::newRow("one non-hex") << txid.left(63) + "g";
+    QTest::newRow("space") << txid.left(31) + " " + txid.mid(32);
+}
+
+void HexKeyTest::invalid()
+{
+    QFETCH(QString, hex);
+
+    bool ok = true;
+    HexKey key = HexKey::fromHex(hex, &ok);
+    QVERIFY(!ok);
+    QVERIFY(key.isNull());
+}
+
+void HexKeyTest::null()
+{
+    HexKey key;
+    QVERIFY(key.isNull());
+    QCOMPARE(key.toHex(), QString(64, '0'));
+
+    bool ok = false;
+    QVERIFY(HexKey::fromHex(QString(64, '0'), &ok).isNull());
+    QVERIFY(ok);
+}
+
+void HexKeyTest::fromPod()
+{
+    struct Pod {
+        unsigned char data[32];
+    } pod{};
+    pod.data[0] = 0x01;
+    pod.data[31] = 0xff;
+
+    HexKey key = HexKey::fromPod(pod);
+    QCOMPARE(key.toHex(), "01" + QString(60, '0') + "ff");
+}
+
+void HexKeyTest::hash()
+{
+    HexKey a = HexKey::fromHex(txid);
+    HexKey b = HexKey::fromHex(txid);
+    HexKey c = HexKey::fromHex(QString(txid).replace(0, 2, "00"));
+
+    QVERIFY(a == b);
+    QVERIFY(a != c);
+    QCOMPARE(qHash(a), qHash(b));
+
+    QSet<HexKey> keys{a, b, c};
+    QCOMPARE(keys.size(), 2);
+    QVERIFY(keys.contains(HexKey::fromHex(txid)));
+}
+
+QTEST_GUILESS_MAIN(HexKeyTest)
+#include "HexKeyTest.moc"
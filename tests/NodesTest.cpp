@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include <QtTest>
+
+#include "utils/nodes.h"
+
+class NodesTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseAddress();
+    void parseZmq();
+    void parseZmqWithCredentials();
+    void ignoreUnknownSettings();
+    void zmqRoundTrip();
+};
+
+void NodesTest::parseAddress()
+{
+    FeatherNode node("node.example.org:18089");
+    QVERIFY(node.isValid());
+    QCOMPARE(node.url.host(), QString("node.example.org"));
+    QCOMPARE(node.url.port(), 18089);
+    QVERIFY(node.zmq.isEmpty());
+
+    FeatherNode defaultPort("127.0.0.1");
+    QCOMPARE(defaultPort.url.port(), 18081);
+    QCOMPARE(defaultPort.toFullAddress(), QString("127.0.0.1:18081"));
+}
+
+void NodesTest::parseZmq()
+{
+    FeatherNode node("127.0.0.1:18081 zmq=tcp://127.0.0.1:18083");
+    QVERIFY(node.isValid());
+    QCOMPARE(node.url.host(), QString("127.0.0.1"));
+    QCOMPARE(node.url.port(), 18081);
+    QCOMPARE(node.zmq, QString("tcp://127.0.0.1:18083"));
+    QCOMPARE(node.toAddress(), QString("127.0.0.1:18081"));
+
+    // Settings may be separated by more than one space
+    FeatherNode spaced("  127.0.0.1:18081   zmq=tcp://127.0.0.1:18083 ");
+    QCOMPARE(spaced.url.port(), 18081);
+    QCOMPARE(spaced.zmq, QString("tcp://127.0.0.1:18083"));
+}
+
+void NodesTest::parseZmqWithCredentials()
+{
+    FeatherNode node("user:pass@10.0.0.2:18081 zmq=tcp://10.0.0.2:18083");
+    QCOMPARE(node.url.userName(), QString("user"));
+    QCOMPARE(node.url.password(), QString("pass"));
+    QCOMPARE(node.url.host(), QString("10.0.0.2"));
+    QCOMPARE(node.zmq, QString("tcp://10.0.0.2:18083"));
+}
+
+void NodesTest::ignoreUnknownSettings()
+{
+    FeatherNode node("127.0.0.1:18081 foo=bar zmq=tcp://127.0.0.1:18083");
+    QCOMPARE(node.url.port(), 18081);
+    QCOMPARE(node.zmq, QString("tcp://127.0.0.1:18083"));
+
+    FeatherNode empty("127.0.0.1:18081 zmq=");
+    QVERIFY(empty.zmq.isEmpty());
+    QCOMPARE(empty.toFullAddress(), QString("127.0.0.1:18081"));
+}
+
+void NodesTest::zmqRoundTrip()
+{
+    // Custom nodes are stored with toFullAddress() and parsed again on startup
+    FeatherNode node("user:pass@127.0.0.1:18081 zmq=tcp://127.0.0.1:18083");
+    FeatherNode parsed(node.toFullAddress());
+    QCOMPARE(parsed.url, node.url);
+    QCOMPARE(parsed.zmq, node.zmq);
+    QCOMPARE(parsed.toFullAddress(), QString("user:pass@127.0.0.1:18081 zmq=tcp://127.0.0.1:18083"));
+}
+
+QTEST_GUILESS_MAIN(NodesTest)
+#include "NodesTest.moc"
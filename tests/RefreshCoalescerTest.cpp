@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include <QtTest>
+
+#include "libwalletqt/RefreshCoalescer.h"
+
+class RefreshCoalescerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void burstRefreshesOnce();
+    void steadyStreamIsNotPostponed();
+    void flush();
+    void flushWithoutRequest();
+};
+
+void RefreshCoalescerTest::burstRefreshesOnce()
+{
+    RefreshCoalescer coalescer(50);
+    QSignalSpy spy(&coalescer, &RefreshCoalescer::refresh);
+
+    for (int i = 0; i < 100; ++i) {
+        coalescer.schedule();
+    }
+    QVERIFY(coalescer.isPending());
+    QCOMPARE(spy.count(), 0);
+
+    QVERIFY(spy.wait(1000));
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(!coalescer.isPending());
+
+    // Nothing requested since, nothing to refresh
+    QTest::qWait(150);
+    QCOMPARE(spy.count(), 1);
+}
+
+void RefreshCoalescerTest::steadyStreamIsNotPostponed()
+{
+    RefreshCoalescer coalescer(100);
+    QSignalSpy spy(&coalescer, &RefreshCoalescer::refresh);
+
+    // Requests every 10 ms for 500 ms: a timer restarted by every request would never fire
+    QElapsedTimer elapsed;
+    elapsed.start();
+    while (elapsed.elapsed() < 500) {
+        coalescer.schedule();
+        QTest::qWait(10);
+    }
+
+    QVERIFY(spy.count() >= 2);
+    QVERIFY(spy.count() <= 6);
+}
+
+void RefreshCoalescerTest::flush()
+{
+    RefreshCoalescer coalescer(10000);
+    QSignalSpy spy(&coalescer, &RefreshCoalescer::refresh);
+
+    coalescer.schedule();
+    coalescer.schedule();
+    coalescer.flush();
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(!coalescer.isPending());
+
+    // The interval was cancelled with it
+    coalescer.schedule();
+    coalescer.flush();
+    QCOMPARE(spy.count(), 2);
+}
+
+void RefreshCoalescerTest::flushWithoutRequest()
+{
+    RefreshCoalescer coalescer(50);
+    QSignalSpy spy(&coalescer, &RefreshCoalescer::refresh);
+
+    coalescer.flush();
+    QCOMPARE(spy.count(), 0);
+
+    coalescer.schedule();
+    coalescer.flush();
+    coalescer.flush();
+    QCOMPARE(spy.count(), 1);
+
+    QTest::qWait(150);
+    QCOMPARE(spy.count(), 1);
+}
+
+QTEST_GUILESS_MAIN(RefreshCoalescerTest)
+#include "RefreshCoalescerTest.moc"
@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include <QtTest>
+
+#include "libwalletqt/rows/RowDelta.h"
+
+namespace {
+    struct Row {
+        int key;
+        QString value;
+
+        bool operator==(const Row &other) const {
+            return key == other.key && value == other.value;
+        }
+    };
+
+    QList<Row> makeRows(const QList<int> &keys, const QString &value = "a") {
+        QList<Row> rows;
+        for (int key : keys) {
+            rows.append({key, value});
+        }
+        return rows;
+    }
+
+    // Replays the deltas against a copy of the old rows, like a view following the model's signals
+    struct Diff {
+        QList<Row> rows;
+        QList<Row> view;
+        QList<RowDelta> deltas;
+        bool applied = false;
+
+        Diff(const QList<Row> &oldRows, QList<Row> newRows) : rows(oldRows), view(oldRows) {
+            int open = 0;
+            applied = applyRowDiff(rows, newRows,
+                [](const Row &row) { return row.key; },
+                [](const Row &a, const Row &b) { return a.value == b.value; },
+                [&open](const RowDelta &) { open++; },
+                [this, &open](const RowDelta &delta) {
+                    open--;
+                    deltas.append(delta);
+                    qsizetype count = delta.last - delta.first + 1;
+                    switch (delta.type) {
+                        case RowDelta::Removed:
+                            view.remove(delta.first, count);
+                            break;
+                        case RowDelta::Inserted:
+                            for (qsizetype i = delta.first; i <= delta.last; ++i) {
+                                view.insert(i, rows[i]);
+                            }
+                            break;
+                        case RowDelta::Updated:
+                            for (qsizetype i = delta.first; i <= delta.last; ++i) {
+                                view[i] = rows[i];
+                            }
+                            break;
+                    }
+                });
+            QCOMPARE(open, 0);
+        }
+    };
+}
+
+class RowDeltaTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void unchanged();
+    void insertRemove_data();
+    void insertRemove();
+    void updateRanges();
+    void mixed();
+    void reordered();
+};
+
+void RowDeltaTest::unchanged()
+{
+    QList<Row> rows = makeRows({1, 2, 3});
+    Diff diff(rows, rows);
+    QVERIFY(diff.applied);
+    QVERIFY(diff.deltas.isEmpty());
+    QCOMPARE(diff.rows, rows);
+}
+
+void RowDeltaTest::insertRemove_data()
+{
+    QTest::addColumn<QList<int>>("oldKeys");
+    QTest::addColumn<QList<int>>("newKeys");
+    QTest::addColumn<int>("deltaCount");
+
+    QTest::newRow("from empty") << QList<int>{} << QList<int>{1, 2, 3} << 1;
+    QTest::newRow("to empty") << QList<int>{1, 2, 3} << QList<int>{} << 1;
+    QTest::newRow("append") << QList<int>{1, 2} << QList<int>{1, 2, 3, 4} << 1;
+    QTest::newRow("prepend") << QList<int>{3, 4} << QList<int>{1, 2, 3, 4} << 1;
+    QTest::newRow("insert in between") << QList<int>{1, 4, 7} << QList<int>{1, 2, 3, 4, 5, 6, 7} << 2;
+    QTest::newRow("remove in between") << QList<int>{1, 2, 3, 4, 5, 6, 7} << QList<int>{1, 4, 7} << 2;
+    QTest::newRow("remove head and tail") << QList<int>{1, 2, 3, 4, 5} << QList<int>{3} << 2;
+}
+
+void RowDeltaTest::insertRemove()
+{
+    QFETCH(QList<int>, oldKeys);
+    QFETCH(QList<int>, newKeys);
+    QFETCH(int, deltaCount);
+
+    QList<Row> newRows = makeRows(newKeys);
+    Diff diff(makeRows(oldKeys), newRows);
+    QVERIFY(diff.applied);
+    QCOMPARE(diff.rows, newRows);
+    QCOMPARE(diff.view, newRows);
+
+    // Contiguous rows are reported as one range
+    QCOMPARE(diff.deltas.size(), deltaCount);
+    for (const auto &delta : diff.deltas) {
+        QVERIFY(delta.type != RowDelta::Updated);
+    }
+}
+
+void RowDeltaTest::updateRanges()
+{
+    QList<Row> newRows = makeRows({1, 2, 3, 4, 5});
+    newRows[1].value = "b";
+    newRows[2].value = "b";
+    newRows[4].value = "b";
+
+    Diff diff(makeRows({1, 2, 3, 4, 5}), newRows);
+    QVERIFY(diff.applied);
+    QCOMPARE(diff.rows, newRows);
+    QCOMPARE(diff.view, newRows);
+
+    QCOMPARE(diff.deltas.size(), 2);
+    QCOMPARE(diff.deltas[0].type, RowDelta::Updated);
+    QCOMPARE(diff.deltas[0].first, qsizetype(1));
+    QCOMPARE(diff.deltas[0].last, qsizetype(2));
+    QCOMPARE(diff.deltas[1].type, RowDelta::Updated);
+    QCOMPARE(diff.deltas[1].first, qsizetype(4));
+    QCOMPARE(diff.deltas[1].last, qsizetype(4));
+}
+
+void RowDeltaTest::mixed()
+{
+    QList<Row> newRows = makeRows({0, 2, 3, 5, 8, 9});
+    newRows[2].value = "b";
+
+    Diff diff(makeRows({1, 2, 3, 4, 5, 6}), newRows);
+    QVERIFY(diff.applied);
+    QCOMPARE(diff.rows, newRows);
+    QCOMPARE(diff.view, newRows);
+
+    // Removals come first, back to front, updates last
+    QList<RowDelta::Type> types;
+    for (const auto &delta : diff.deltas) {
+        types.append(delta.type);
+    }
+    QCOMPARE(types, (QList<RowDelta::Type>{RowDelta::Removed, RowDelta::Removed, RowDelta::Removed,
+                                           RowDelta::Inserted, RowDelta::Inserted, RowDelta::Updated}));
+    QCOMPARE(diff.deltas[0].first, qsizetype(5));
+    QCOMPARE(diff.deltas[1].first, qsizetype(3));
+    QCOMPARE(diff.deltas[2].first, qsizetype(0));
+}
+
+void RowDeltaTest::reordered()
+{
+    QList<Row> oldRows = makeRows({1, 2, 3, 4});
+    QList<Row> newRows = makeRows({1, 3, 2, 5}, "b");
+
+    QList<Row> rows = oldRows;
+    QList<Row> consumed = newRows;
+    int calls = 0;
+    bool applied = applyRowDiff(rows, consumed,
+        [](const Row &row) { return row.key; },
+        [](const Row &a, const Row &b) { return a.value == b.value; },
+        [&calls](const RowDelta &) { calls++; },
+        [&calls](const RowDelta &) { calls++; });
+
+    // The caller resets instead, nothing may have been touched
+    QVERIFY(!applied);
+    QCOMPARE(calls, 0);
+    QCOMPARE(rows, oldRows);
+    QCOMPARE(consumed, newRows);
+}
+
+QTEST_GUILESS_MAIN(RowDeltaTest)
+#include "RowDeltaTest.moc"
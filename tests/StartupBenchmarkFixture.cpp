@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+// Creates the wallet the startup benchmark opens from the keys in fixtures/startup_wallet.json.
+// The wallet is created again on every run, so the benchmark always opens a wallet that was never opened before.
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <wallet/api/wallet2_api.h>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList args = QCoreApplication::arguments();
+    if (args.size() != 3) {
+        qCritical() << "Usage: StartupBenchmarkFixture <fixture.json> <wallet path>";
+        return EXIT_FAILURE;
+    }
+
+    QFile fixtureFile(args[1]);
+    if (!fixtureFile.open(QIODevice::ReadOnly)) {
+        qCritical() << "Unable to read fixture:" << args[1];
+        return EXIT_FAILURE;
+    }
+    QJsonObject fixture = QJsonDocument::fromJson(fixtureFile.readAll()).object();
+
+    Monero::NetworkType nettype;
+    QString network = fixture.value("network").toString();
+    if (network == "mainnet") {
+        nettype = Monero::MAINNET;
+    } else if (network == "testnet") {
+        nettype = Monero::TESTNET;
+    } else if (network == "stagenet") {
+        nettype = Monero::STAGENET;
+    } else {
+        qCritical() << "Unknown network in fixture:" << network;
+        return EXIT_FAILURE;
+    }
+
+    QString path = args[2];
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    for (const QString &file : {path, path + ".keys", path + ".address.txt"}) {
+        QFile::remove(file);
+    }
+
+    Monero::WalletManagerFactory::setLogLevel(-1);
+    Monero::WalletManager *manager = Monero::WalletManagerFactory::getWalletManager();
+
+    // Opened by the benchmark with an empty password
+    Monero::Wallet *wallet = manager->createDeterministicWalletFromSpendKey(path.toStdString(), "", "English", nettype,
+                                                                           fixture.value("restore_height").toInteger(),
+                                                                           fixture.value("spend_key").toString().toStdString(),
+                                                                           1, "", "");
+    if (wallet->status() != Monero::Wallet::Status_Ok) {
+        qCritical() << "Unable to create wallet:" << QString::fromStdString(wallet->errorString());
+        manager->closeWallet(wallet, false);
+        return EXIT_FAILURE;
+    }
+
+    bool stored = wallet->store("");
+    if (!stored) {
+        qCritical() << "Unable to store wallet:" << QString::fromStdString(wallet->errorString());
+    }
+    manager->closeWallet(wallet, false);
+
+    return stored ? EXIT_SUCCESS : EXIT_FAILURE;
+}
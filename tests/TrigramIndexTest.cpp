@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: The Monero Project
+
+#include <QtTest>
+
+#include "utils/TrigramIndex.h"
+
+class TrigramIndexTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void candidates();
+    void caseInsensitive();
+    void shortQuery();
+    void remove();
+    void containsEveryMatch();
+    void isPlain();
+};
+
+void TrigramIndexTest::candidates()
+{
+    TrigramIndex<quint32> index;
+    index.insert(1, "Hello World");
+    index.insert(2, "yellow");
+    index.insert(3, "abc");
+
+    auto result = index.candidates("ello");
+    QVERIFY(result.has_value());
+    QCOMPARE(*result, (QSet<quint32>{1, 2}));
+
+    result = index.candidates("abc");
+    QVERIFY(result.has_value());
+    QCOMPARE(*result, QSet<quint32>{3});
+
+    // A trigram nobody has, nothing to verify
+    result = index.candidates("xyz");
+    QVERIFY(result.has_value());
+    QVERIFY(result->isEmpty());
+}
+
+void TrigramIndexTest::caseInsensitive()
+{
+    TrigramIndex<quint32> index;
+    index.insert(1, "Hello World");
+    index.insert(2, "yellow");
+
+    auto result = index.candidates("WORLD");
+    QVERIFY(result.has_value());
+    QCOMPARE(*result, QSet<quint32>{1});
+
+    result = index.candidates("YeLLo");
+    QVERIFY(result.has_value());
+    QCOMPARE(*result, QSet<quint32>{2});
+}
+
+void TrigramIndexTest::shortQuery()
+{
+    TrigramIndex<quint32> index;
+    index.insert(1, "abc");
+
+    // Too short for a trigram, the caller has to scan
+    QVERIFY(!index.candidates("").has_value());
+    QVERIFY(!index.candidates("ab").has_value());
+    QVERIFY(index.candidates("abc").has_value());
+}
+
+void TrigramIndexTest::remove()
+{
+    TrigramIndex<quint32> index;
+    index.insert(1, "Hello World");
+    index.insert(2, "yellow");
+
+    index.remove(2, "yellow");
+    QCOMPARE(*index.candidates("ello"), QSet<quint32>{1});
+    QVERIFY(index.candidates("yel")->isEmpty());
+
+    // Removing an id that isn't there leaves the others alone
+    index.remove(3, "Hello");
+    QCOMPARE(*index.candidates("ello"), QSet<quint32>{1});
+
+    index.clear();
+    QVERIFY(index.candidates("ello")->isEmpty());
+}
+
+void TrigramIndexTest::containsEveryMatch()
+{
+    const QStringList texts = {
+        "Primary account", "Savings", "payment for coffee", "4AdUndXHHZ6cfufTMvppY6JwXNouMBzSkbLYfpAV5Usx",
+        "coffee", "Offline", "", "aaaa", "tx note: rent"
+    };
+    const QStringList queries = {"acc", "ffee", "COFF", "aaa", "aaaa", "note: r", "sav", "y6j", "nothing"};
+
+    TrigramIndex<quint32> index;
+    for (qsizetype i = 0; i < texts.size(); ++i) {
+        index.insert(quint32(i), texts[i]);
+    }
+
+    for (const auto &query : queries) {
+        auto result = index.candidates(query);
+        QVERIFY(result.has_value());
+        for (qsizetype i = 0; i < texts.size(); ++i) {
+            if (texts[i].contains(query, Qt::CaseInsensitive)) {
+                QVERIFY2(result->contains(quint32(i)), qPrintable(QString("%1 in %2").arg(query, texts[i])));
+            }
+        }
+    }
+}
+
+void TrigramIndexTest::isPlain()
+{
+    QVERIFY(TrigramIndex<quint32>::isPlain("coffee"));
+    QVERIFY(TrigramIndex<quint32>::isPlain("tx note: rent"));
+    QVERIFY(!TrigramIndex<quint32>::isPlain("a.c"));
+    QVERIFY(!TrigramIndex<quint32>::isPlain("^abc"));
+    QVERIFY(!TrigramIndex<quint32>::isPlain("a|b"));
+    QVERIFY(!TrigramIndex<quint32>::isPlain("[0-9]+"));
+}
+
+QTEST_GUILESS_MAIN(TrigramIndexTest)
+#include "TrigramIndexTest.moc"